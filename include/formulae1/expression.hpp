@@ -1,13 +1,18 @@
 #pragma once
 
 #include <concepts>
-#include <memory>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#include <formulae1/expression_context.hpp>
+#include <formulae1/expression_symbol.hpp>
+#include <formulae1/z3_resource.hpp>
 
 // NOLINTNEXTLINE [cert-dcl51-cpp]
 struct _Z3_ast;
-// NOLINTNEXTLINE [cert-dcl51-cpp]
-struct _Z3_context;
 
 extern "C"
 {
@@ -24,8 +29,6 @@ namespace fml
         || (std::same_as<T, std::remove_cvref_t<T>> && !std::same_as<T, bool> && std::is_integral_v<T>);
     // clang-format on
 
-    template <typename, typename ResourceBase, void(_Z3_context*, ResourceBase*), void(_Z3_context*, ResourceBase*)>
-    class z3_resource;
     using z3_ast = z3_resource<_Z3_ast, _Z3_ast, Z3_inc_ref, Z3_dec_ref>;
 
     template <typename = void,
@@ -35,6 +38,14 @@ namespace fml
 
     template <typename T = void>
     [[nodiscard]] expression<T> parse_expression(std::string const&);
+    template <typename T = void>
+    [[nodiscard]] expression<T> parse_expression(expression_context const&, std::string const&);
+
+    // Copies an expression into another context (by default the one of the calling thread)
+    template <typename T>
+    [[nodiscard]] expression<T> translate(expression<T> const&);
+    template <typename T>
+    [[nodiscard]] expression<T> translate(expression<T> const&, expression_context const&);
 
     template <typename T>
     std::ostream& operator<<(std::ostream&, expression<T> const&) noexcept;
@@ -46,19 +57,31 @@ namespace fml
     {
         template <typename, typename>
         friend class expression;
+        friend class expression_analysis;
         friend class expression_model;
         friend class expression_solver;
+        friend class expression_substitution;
 
         friend struct std::hash<expression>;
 
-        friend expression parse_expression<>(std::string const&);
+        friend expression parse_expression<>(expression_context const&, std::string const&);
+        template <typename T>
+        friend expression<T> translate(expression<T> const&, expression_context const&);
 
-        std::unique_ptr<z3_ast> base_;
+        // Concrete expressions hold their value natively and build a term only on demand
+        mutable z3_ast base_;
+        std::uint64_t value_{};
+        // Width in bytes (zero for Boolean values)
+        std::uint8_t size_{};
+        bool concrete_{};
+        // Simplification may be deferred until the expression is observed
+        mutable bool simplification_pending_{};
 
         explicit expression(z3_ast) noexcept;
+        explicit expression(z3_context const&, std::size_t size, std::uint64_t value) noexcept;
 
     public:
-        virtual ~expression() noexcept;
+        ~expression() noexcept;
 
         template <integral_expression_typename T>
         explicit expression(expression<T> const&) noexcept;
@@ -89,13 +112,36 @@ namespace fml
         [[nodiscard]] T evaluate() const;
 
         [[nodiscard]] std::unordered_set<std::string> dependencies() const noexcept;
+        // Same as dependencies, but as interned symbols in ascending order
+        [[nodiscard]] std::vector<symbol_id> dependency_ids() const noexcept;
         [[nodiscard]] std::unordered_set<expression> dependencies_indirect() const noexcept;
 
         void substitute(std::string const& key_symbol, expression const& value) noexcept;
+        // Replaces all given symbols at once
+        void substitute(std::unordered_map<std::string, expression> const& values) noexcept;
         void substitute_indirect(expression const& key_pointer, expression<std::byte> const& value) noexcept;
+        // Replaces all given indirections at once
+        void substitute_indirect(std::unordered_map<expression, expression<std::byte>> const& values) noexcept;
 
     private:
         [[nodiscard]] std::size_t size() const noexcept;
+
+        // Term of the expression, built from the concrete value if necessary
+        [[nodiscard]] z3_ast const& base() const noexcept;
+        // Term of the expression, about to be updated symbolically
+        [[nodiscard]] z3_ast& base_symbolic() noexcept;
+
+        // Native bits of a constant expression
+        [[nodiscard]] std::optional<std::uint64_t> value() const noexcept;
+
+        // Evaluates operations on constant operands natively instead of building a term
+        template <typename Result>
+        [[nodiscard]] static std::optional<Result> fold(expression const&, expression const&, Result (*)(std::uint64_t, std::uint64_t)) noexcept;
+
+        // Simplifies right away or, in lazy mode, defers until observation
+        void simplify() noexcept;
+        // Applies a deferred simplification
+        void observe() const noexcept;
     };
 
     template <>
@@ -104,15 +150,22 @@ namespace fml
         template <typename, typename>
         friend class expression;
         friend class expression_model;
+        friend class expression_substitution;
 
-        friend expression parse_expression<>(std::string const&);
+        friend expression parse_expression<>(expression_context const&, std::string const&);
+        friend expression translate<>(expression const&, expression_context const&);
 
         explicit expression(z3_ast) noexcept;
+        explicit expression(z3_context const&, bool) noexcept;
 
     public:
         explicit expression(bool) noexcept;
+        explicit expression(expression_context const&, bool) noexcept;
 
         [[nodiscard]] static expression symbol(std::string const& symbol);
+        [[nodiscard]] static expression symbol(expression_context const&, std::string const& symbol);
+        [[nodiscard]] static expression symbol(symbol_id);
+        [[nodiscard]] static expression symbol(expression_context const&, symbol_id);
 
         template <integral_expression_typename T>
         explicit expression(expression<T> const&);
@@ -141,15 +194,22 @@ namespace fml
         template <typename, typename>
         friend class expression;
         friend class expression_model;
+        friend class expression_substitution;
 
-        friend expression parse_expression<>(std::string const&);
+        friend expression parse_expression<>(expression_context const&, std::string const&);
+        friend expression translate<>(expression const&, expression_context const&);
 
         explicit expression(z3_ast) noexcept;
+        explicit expression(z3_context const&, T) noexcept;
 
     public:
         explicit expression(T) noexcept;
+        explicit expression(expression_context const&, T) noexcept;
 
         [[nodiscard]] static expression symbol(std::string const& symbol);
+        [[nodiscard]] static expression symbol(expression_context const&, std::string const& symbol);
+        [[nodiscard]] static expression symbol(symbol_id);
+        [[nodiscard]] static expression symbol(expression_context const&, symbol_id);
 
         explicit expression(expression<bool> const&) noexcept;
 
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <formulae1/expression.hpp>
+
+namespace fml
+{
+    // Facts that hold for every value of an expression
+    struct expression_bounds
+    {
+        // Bits known to be cleared or set
+        std::uint64_t known_zeros{};
+        std::uint64_t known_ones{};
+
+        // Inclusive ranges of the values, read as unsigned and as signed (two's complement) numbers
+        std::uint64_t unsigned_minimum{};
+        std::uint64_t unsigned_maximum{};
+        std::int64_t signed_minimum{};
+        std::int64_t signed_maximum{};
+    };
+
+    // Derives known bits and value ranges of expressions from their structure alone, without consulting a solver.
+    // The results are sound, but not necessarily tight.
+    // Facts about subterms are remembered across queries, so terms shared between expressions are analyzed only once.
+    class expression_analysis
+    {
+        struct state;
+
+        std::unique_ptr<state> base_;
+
+    public:
+        explicit expression_analysis();
+
+        ~expression_analysis() noexcept;
+
+        expression_analysis(expression_analysis const&);
+        expression_analysis& operator=(expression_analysis const&);
+
+        expression_analysis(expression_analysis&&) noexcept;
+        expression_analysis& operator=(expression_analysis&&) noexcept;
+
+        template <integral_expression_typename T>
+        [[nodiscard]] expression_bounds bounds(expression<T> const&);
+
+        // Truth value of a formula, if the bounds of its operands decide it
+        [[nodiscard]] std::optional<bool> decide(expression<bool> const&);
+
+        // Number of facts (bounds and truth values of terms) remembered so far
+        [[nodiscard]] std::size_t size() const noexcept;
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace fml
+{
+    class z3_context;
+
+    enum class context_mode
+    {
+        // All threads share the same context (default)
+        shared,
+        // Each thread uses a context of its own
+        per_thread
+    };
+
+    // Selects which context newly created expressions, models and solvers are assigned to.
+    // Existing objects remain with the context they have been created in.
+    void select_context_mode(context_mode) noexcept;
+    [[nodiscard]] context_mode selected_context_mode() noexcept;
+
+    enum class simplification_mode
+    {
+        // Simplify after every operation (default)
+        eager,
+        // Build raw terms and simplify once on observation (evaluation, comparison, solving, ...)
+        lazy
+    };
+
+    // Isolated universe of expressions, models and solvers.
+    // Everything created within a context has to be destroyed before the context itself,
+    // which then releases all remaining memory at once.
+    // A context must not be used by multiple threads simultaneously.
+    class expression_context
+    {
+        friend class z3_context;
+
+        std::unique_ptr<z3_context> base_;
+
+    public:
+        explicit expression_context() noexcept;
+
+        ~expression_context() noexcept;
+
+        expression_context(expression_context const&) = delete;
+        expression_context& operator=(expression_context const&) = delete;
+
+        expression_context(expression_context&&) noexcept;
+        expression_context& operator=(expression_context&&) noexcept;
+
+        void select_simplification_mode(simplification_mode) noexcept;
+        [[nodiscard]] simplification_mode selected_simplification_mode() const noexcept;
+
+        // Number of terms whose symbol dependencies are remembered, so that repeated queries do not walk them again.
+        // Zero (default) disables caching.
+        void select_dependency_cache_capacity(std::size_t) noexcept;
+        [[nodiscard]] std::size_t selected_dependency_cache_capacity() const noexcept;
+
+        // Context used by default on the calling thread, depending on the selected context mode
+        [[nodiscard]] static expression_context& current() noexcept;
+    };
+}
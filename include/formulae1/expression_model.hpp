@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include <formulae1/expression.hpp>
 
 // NOLINTNEXTLINE [cert-dcl51-cpp]
@@ -17,6 +19,7 @@ namespace fml
 
     class expression_model
     {
+        friend class check_task;
         friend class expression_solver;
 
         std::unique_ptr<z3_model> base_;
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <chrono>
+#include <list>
 #include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include <formulae1/expression_analysis.hpp>
 #include <formulae1/expression_model.hpp>
 
 // NOLINTNEXTLINE [cert-dcl51-cpp]
@@ -17,12 +24,156 @@ namespace fml
 {
     using z3_solver = z3_resource<_Z3_solver, _Z3_solver, Z3_solver_inc_ref, Z3_solver_dec_ref>;
 
+    enum class query_mode
+    {
+        // Formulas are checked as temporary assumptions (default)
+        assumption,
+        // The top-level conjuncts of formulas are asserted in scopes of their own,
+        // kept for the next formula as far as it starts with the same conjuncts
+        prefix_sharing
+    };
+
+    enum class satisfiability
+    {
+        unsatisfiable,
+        satisfiable,
+        // Neither could be shown, e.g. within the limits
+        unknown
+    };
+
+    // Bounds on the effort of each underlying check, zero meaning unbounded
+    struct solver_limits
+    {
+        // Wall-clock time
+        std::chrono::milliseconds timeout{};
+        // Deterministic Z3 resource units, which do not depend on the load of the machine
+        unsigned resource_limit{};
+    };
+
+    struct check_result
+    {
+        satisfiability status{satisfiability::unknown};
+        // Present if satisfiable
+        std::optional<expression_model> model;
+    };
+
+    // Check running on a thread of its own, on a copy of the solver within a private context.
+    // Cancels the check on destruction unless it has finished.
+    class check_task
+    {
+        friend class expression_solver;
+
+        struct state;
+        std::unique_ptr<state> state_;
+
+        explicit check_task(std::unique_ptr<state>) noexcept;
+
+    public:
+        ~check_task() noexcept;
+
+        check_task(check_task const&) = delete;
+        check_task& operator=(check_task const&) = delete;
+
+        check_task(check_task&&) noexcept;
+        check_task& operator=(check_task&&) noexcept;
+
+        [[nodiscard]] bool ready() const noexcept;
+
+        // Waits for the check to finish; can only be called once.
+        // The model is moved to the context of the solver, which must not be in use by other threads meanwhile.
+        [[nodiscard]] check_result get();
+
+        // Interrupts the check (unless finished), which then reports unknown satisfiability.
+        // Returns as soon as the check has stopped.
+        void cancel() noexcept;
+    };
+
+    enum class solver_strategy
+    {
+        // Incremental SMT solver (default)
+        simple,
+        // Z3's general-purpose solver, which picks a strategy depending on the formula
+        general,
+        // Bit-blasting to SAT after simplification
+        bit_blast
+    };
+
+    struct solver_configuration
+    {
+        solver_strategy strategy{solver_strategy::simple};
+        unsigned random_seed{};
+    };
+
+    enum class slicing_mode
+    {
+        // Formulas are checked as a whole (default)
+        none,
+        // The top-level conjuncts of formulas are split into groups without shared symbols or memory,
+        // which are checked separately; groups are only reused across queries through the result
+        // cache (see select_cache_capacity), without which every group is checked again each time
+        independence
+    };
+
+    // Keeps assertions across checks, so that clauses learned for a common prefix are reused.
+    // Copies start out with the assertions of the original, but without its scopes and cached results.
     class expression_solver
     {
         std::unique_ptr<z3_solver> base_;
 
+        solver_limits limits_{};
+        // Limits currently configured in Z3
+        mutable solver_limits applied_limits_{};
+
+        bool model_generation_{true};
+        // Cleared while checking satisfiability only
+        mutable bool models_requested_{true};
+
+        query_mode query_mode_{query_mode::assumption};
+        // Conjuncts asserted on top of all other scopes
+        mutable std::vector<z3_ast> prefix_;
+
+        // Terms and symbols of the assertions, and whether these read memory
+        std::vector<z3_ast> assertions_;
+        std::vector<symbol_id> assertion_dependencies_;
+        bool assertion_indirect_{};
+        // Extents of the above as of each open scope
+        struct assertion_scope
+        {
+            std::size_t assertion_count;
+            std::size_t dependency_count;
+            bool indirect;
+        };
+        std::vector<assertion_scope> assertion_scopes_;
+
+        slicing_mode slicing_mode_{slicing_mode::none};
+
+        std::vector<solver_configuration> portfolio_;
+
+        unsigned split_depth_{};
+
+        std::size_t cache_capacity_{};
+        // Results of recent formulas, most recently used first
+        mutable std::list<std::pair<z3_ast, check_result>> cache_entries_;
+        mutable std::unordered_map<_Z3_ast*, decltype(cache_entries_)::iterator> cache_index_;
+        mutable std::size_t cache_hits_{};
+        mutable std::size_t cache_misses_{};
+
+        std::size_t counterexample_capacity_{};
+        // Recent models, most recently used first
+        mutable std::list<expression_model> counterexamples_;
+        // Recent sets of unsatisfiable constraints, each ordered by address
+        mutable std::list<std::vector<z3_ast>> unsatisfiable_sets_;
+        mutable std::size_t counterexample_hits_{};
+
+        // Model of trivially satisfiable checks, created on first use
+        mutable std::optional<expression_model> empty_model_;
+        // Facts about the terms of previous queries, for subterms they share with later ones
+        mutable expression_analysis analysis_;
+        mutable std::size_t trivial_hits_{};
+
     public:
         explicit expression_solver() noexcept;
+        explicit expression_solver(expression_context const&) noexcept;
 
         ~expression_solver() noexcept;
 
@@ -32,6 +183,132 @@ namespace fml
         expression_solver(expression_solver&&) noexcept;
         expression_solver& operator=(expression_solver&&) noexcept;
 
-        [[nodiscard]] std::optional<expression_model> check(expression<bool> const&) const;
+        void select_limits(solver_limits) noexcept;
+        [[nodiscard]] solver_limits selected_limits() const noexcept;
+
+        // Without model generation (enabled by default), satisfiable results come without a model and check throws on them.
+        void select_model_generation(bool) noexcept;
+        [[nodiscard]] bool selected_model_generation() const noexcept;
+
+        void select_query_mode(query_mode) noexcept;
+        [[nodiscard]] query_mode selected_query_mode() const noexcept;
+
+        // Races the given configurations on copies of the solver (in threads and contexts of their own) for each check,
+        // taking the first definite answer and interrupting the others.
+        // Empty (default) checks with the solver alone.
+        void select_portfolio(std::vector<solver_configuration>);
+        [[nodiscard]] std::vector<solver_configuration> const& selected_portfolio() const noexcept;
+
+        // Splits each check into 2^depth cubes by fixing as many bits of the most frequent symbols,
+        // solved in parallel (each in a context of its own) until one is satisfiable or all are not.
+        // Zero (default) disables splitting; takes precedence over a portfolio.
+        void select_split_depth(unsigned) noexcept;
+        [[nodiscard]] unsigned selected_split_depth() const noexcept;
+
+        static constexpr unsigned max_split_depth{16};
+
+        void select_slicing_mode(slicing_mode) noexcept;
+        [[nodiscard]] slicing_mode selected_slicing_mode() const noexcept;
+
+        // Remembers the results of up to the given number of formulas (or independent groups of conjuncts) checked individually.
+        // Zero (default) disables caching. Cached results are discarded whenever assertions change.
+        void select_cache_capacity(std::size_t) noexcept;
+        [[nodiscard]] std::size_t selected_cache_capacity() const noexcept;
+
+        [[nodiscard]] std::size_t cache_hits() const noexcept;
+        [[nodiscard]] std::size_t cache_misses() const noexcept;
+
+        // Remembers up to the given number of recent models and unsatisfiable constraint sets.
+        // Checks then try these models first and consider supersets of unsatisfiable sets unsatisfiable.
+        // Zero (default) disables the counterexample cache.
+        void select_counterexample_capacity(std::size_t) noexcept;
+        [[nodiscard]] std::size_t selected_counterexample_capacity() const noexcept;
+
+        // Number of checks answered by the counterexample cache
+        [[nodiscard]] std::size_t counterexample_hits() const noexcept;
+
+        // Number of checks decided by the assumptions alone (one false, or all true without assertions),
+        // be they constant or decided by the known bits and ranges of their operands (see expression_analysis)
+        [[nodiscard]] std::size_t trivial_hits() const noexcept;
+        // Number of facts about the terms of previous checks kept to decide later ones,
+        // which are only discarded along with the solver (or when it is assigned to)
+        [[nodiscard]] std::size_t analyzed_facts() const noexcept;
+
+        // Asserts permanently (within the current scope)
+        void add(expression<bool> const&);
+
+        void push() noexcept;
+        void pop(unsigned count = 1);
+
+        // Throws if satisfiability remains unknown
+        [[nodiscard]] std::optional<expression_model> check() const;
+        // Checks the assertions together with temporary assumptions
+        [[nodiscard]] std::optional<expression_model> check(expression<bool> const& assumption) const;
+        [[nodiscard]] std::optional<expression_model> check(std::vector<expression<bool>> const& assumptions) const;
+
+        // Same as check, but without building a model
+        [[nodiscard]] satisfiability check_satisfiability() const;
+        [[nodiscard]] satisfiability check_satisfiability(expression<bool> const& assumption) const;
+        [[nodiscard]] satisfiability check_satisfiability(std::vector<expression<bool>> const& assumptions) const;
+
+        // Same as check, but reports unknown satisfiability instead of throwing
+        [[nodiscard]] check_result solve() const;
+        [[nodiscard]] check_result solve(expression<bool> const& assumption) const;
+        [[nodiscard]] check_result solve(std::vector<expression<bool>> const& assumptions) const;
+        // Applies the given limits instead of the selected ones
+        [[nodiscard]] check_result solve(expression<bool> const& assumption, solver_limits const&) const;
+        [[nodiscard]] check_result solve(std::vector<expression<bool>> const& assumptions, solver_limits const&) const;
+
+        // Lowest and highest value (as ordered by the type) the expression takes on under the assertions and the given constraint;
+        // none if these are unsatisfiable. Found bit by bit on the solver itself, where models skip bits they already reach.
+        // Throws if satisfiability remains unknown.
+        template <integral_expression_typename T>
+        [[nodiscard]] std::optional<std::pair<T, T>> range(expression<T> const& value) const;
+        template <integral_expression_typename T>
+        [[nodiscard]] std::optional<std::pair<T, T>> range(expression<T> const& value, expression<bool> const& constraint) const;
+
+        // Same as solve, but without blocking; caches and slicing do not apply
+        [[nodiscard]] check_task solve_async(expression<bool> const& assumption) const;
+        [[nodiscard]] check_task solve_async(std::vector<expression<bool>> const& assumptions) const;
+
+        // Solves each formula on its own, spread over worker threads with a copy of the solver in a private context each.
+        // Idle workers take over formulas queued for others. Results are in the order of the formulas.
+        // Zero workers means one per hardware thread; caches and slicing do not apply.
+        [[nodiscard]] std::vector<check_result> solve_batch(std::span<expression<bool> const> formulas, std::size_t worker_count = 0) const;
+
+    private:
+        // Decides assumptions by their values or the bounds of their operands, without consulting Z3
+        [[nodiscard]] std::optional<check_result> check_trivial(std::span<expression<bool> const>) const;
+        [[nodiscard]] check_result check_slices(z3_ast const&) const;
+        [[nodiscard]] check_result check_formula(z3_ast const&) const;
+        [[nodiscard]] check_result recall_formula(z3_ast const&) const;
+        [[nodiscard]] check_result solve_formula(z3_ast const&) const;
+        [[nodiscard]] check_result check_assumptions(std::vector<_Z3_ast*> const&) const;
+        [[nodiscard]] check_result check_base(std::vector<_Z3_ast*> const&) const;
+        [[nodiscard]] check_result check_portfolio(std::vector<_Z3_ast*> const&) const;
+        [[nodiscard]] check_result check_cubes(std::vector<_Z3_ast*> const&) const;
+
+        template <integral_expression_typename T>
+        [[nodiscard]] std::optional<std::pair<T, T>> constrained_range(expression<T> const& value, z3_ast const& constraint) const;
+        // Highest unsigned value of a term under a constraint, skipping bits known beforehand
+        [[nodiscard]] std::optional<std::uint64_t> maximize(z3_ast const& term, z3_ast const& constraint, std::uint64_t known_zeros, std::uint64_t known_ones) const;
+
+        // Whether the current check is to provide a model
+        [[nodiscard]] bool generates_models() const noexcept;
+
+        // The given assumptions together with everything asserted
+        [[nodiscard]] std::vector<_Z3_ast*> asserted(std::vector<_Z3_ast*> const& assumptions) const;
+
+        // Looks up a result among the known models and unsatisfiable sets
+        [[nodiscard]] std::optional<check_result> recall(std::vector<z3_ast> const& constraints) const;
+        void remember(std::vector<z3_ast> const& constraints, check_result const&) const;
+
+        void clear_cache() noexcept;
+
+        // Configures Z3 unless already done
+        void apply_limits(solver_limits const&) const noexcept;
+
+        // Drops the scopes of conjuncts kept from a previous formula
+        void release_prefix() const noexcept;
     };
 }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <formulae1/expression.hpp>
+
+namespace fml
+{
+    // Applies the same symbol substitution to many expressions.
+    // Rewritten subterms are remembered across applications, so terms shared between expressions are rewritten only once.
+    // They are kept (along with their terms) for the lifetime of the substitution, so use a new one for unrelated batches of expressions.
+    class expression_substitution
+    {
+        struct state;
+
+        std::unique_ptr<state> base_;
+
+    public:
+        explicit expression_substitution(std::unordered_map<std::string, expression<>> const& values);
+
+        ~expression_substitution() noexcept;
+
+        expression_substitution(expression_substitution const&);
+        expression_substitution& operator=(expression_substitution const&);
+
+        expression_substitution(expression_substitution&&) noexcept;
+        expression_substitution& operator=(expression_substitution&&) noexcept;
+
+        template <typename T>
+        [[nodiscard]] expression<T> apply(expression<T> const&);
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace fml
+{
+    // Compact handle of an interned symbol name
+    enum class symbol_id : std::uint32_t
+    {
+    };
+
+    // Validates a symbol name on first use and assigns it a stable id; later calls only look it up
+    [[nodiscard]] symbol_id intern_symbol(std::string const&);
+    [[nodiscard]] std::string const& symbol_name(symbol_id);
+}
@@ -4,10 +4,13 @@
 #include <functional>
 #include <memory>
 
-#include <z3.h>
+// NOLINTNEXTLINE [cert-dcl51-cpp]
+struct _Z3_context;
 
 namespace fml
 {
+    class z3_context;
+
     // clang-format off
     template <typename Function, typename Value, typename... Arguments>
     concept z3_invocable_input =
@@ -34,13 +37,17 @@ namespace fml
     {
         struct deleter
         {
+            z3_context const* context;
+
             void operator()(Value*) const noexcept;
         };
         class pointer : std::unique_ptr<Value, deleter>
         {
         public:
-            explicit pointer(Value*) noexcept;
-            void reset(Value*) noexcept;
+            explicit pointer(z3_context const&, Value*) noexcept;
+            void reset(z3_context const&, Value*) noexcept;
+
+            [[nodiscard]] z3_context const& context() const noexcept;
 
             using std::unique_ptr<Value, deleter>::get;
         };
@@ -49,9 +56,12 @@ namespace fml
 
     public:
         explicit z3_resource(Value*) noexcept;
+        explicit z3_resource(z3_context const&, Value*) noexcept;
 
         template <typename... Arguments>
         explicit z3_resource(z3_invocable_output<Value, Arguments...> auto const&, Arguments&&...) noexcept;
+        template <typename... Arguments>
+        explicit z3_resource(z3_context const&, z3_invocable_output<Value, Arguments...> auto const&, Arguments&&...) noexcept;
 
         ~z3_resource() noexcept = default;
 
@@ -64,8 +74,10 @@ namespace fml
         // NOLINTNEXTLINE [hicpp-explicit-conversions]
         [[nodiscard]] operator Value*() const noexcept;
 
+        [[nodiscard]] z3_context const& context() const noexcept;
+
         template <typename... Arguments>
-        [[nodiscard]] decltype(auto) apply(z3_invocable_input<Value, Arguments...> auto const&, Arguments&&...) noexcept;
+        [[nodiscard]] decltype(auto) apply(z3_invocable_input<Value, Arguments...> auto const&, Arguments&&...) const noexcept;
 
         template <typename... Arguments>
         void update(z3_invocable_output<Value, Arguments...> auto const&, Arguments&&...) noexcept;
@@ -76,17 +88,23 @@ namespace fml
     class z3_resource<Value, void, nullptr, nullptr>
     {
         Value* base_;
+        z3_context const* context_;
 
     public:
         explicit z3_resource(Value*) noexcept;
+        explicit z3_resource(z3_context const&, Value*) noexcept;
 
         template <typename... Arguments>
         explicit z3_resource(z3_invocable_output<Value, Arguments...> auto const&, Arguments&&...) noexcept;
+        template <typename... Arguments>
+        explicit z3_resource(z3_context const&, z3_invocable_output<Value, Arguments...> auto const&, Arguments&&...) noexcept;
 
         // NOLINTNEXTLINE [hicpp-explicit-conversions]
         [[nodiscard]] operator Value*() const noexcept;
 
+        [[nodiscard]] z3_context const& context() const noexcept;
+
         template <typename... Arguments>
-        [[nodiscard]] decltype(auto) apply(z3_invocable_input<Value, Arguments...> auto const&, Arguments&&...) noexcept;
+        [[nodiscard]] decltype(auto) apply(z3_invocable_input<Value, Arguments...> auto const&, Arguments&&...) const noexcept;
     };
 }
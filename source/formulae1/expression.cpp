@@ -1,13 +1,17 @@
 #include <algorithm>
 #include <array>
 #include <climits>
+#include <limits>
+#include <optional>
 #include <ostream>
 #include <regex>
+#include <vector>
 
 #include <formulae1/expression.hpp>
 
 #include "preprocessor_types.hpp"
 #include "z3_resource.ipp"
+#include "z3_symbol_table.hpp"
 
 namespace fml
 {
@@ -20,30 +24,246 @@ namespace fml
     using z3_symbol = z3_resource<_Z3_symbol>;
     using z3_tactic = z3_resource<_Z3_tactic, _Z3_tactic, Z3_tactic_inc_ref, Z3_tactic_dec_ref>;
 
+    // Symbols are not bound to a specific context
     static z3_symbol const indirection_symbol(Z3_mk_string_symbol, "deref");
 
+    // Term handle (AST and context pointer), native value, then width and flags padded to a word; catches unintended growth on 64-bit targets
+    static_assert(sizeof(void*) != 8 || sizeof(expression<unsigned>) == 32);
+    static_assert(sizeof(expression<unsigned>) == sizeof(expression<>));
+
     template <integral_expression_typename T>
-    static expression<T> const zero(static_cast<T>(0));
+    static z3_ast numeral(z3_context const& context, T const value)
+    {
+        return z3_ast(context, Z3_mk_unsigned_int64, static_cast<std::uint64_t>(value), z3_sort(context, Z3_mk_bv_sort, static_cast<unsigned>(sizeof(T) * CHAR_BIT)));
+    }
+
+    // Native bit-vector operations matching the semantics of their Z3 counterparts
     template <integral_expression_typename T>
-    static expression<T> const one(static_cast<T>(1));
+    struct numeral_arithmetic
+    {
+        static constexpr std::uint64_t width = sizeof(T) * CHAR_BIT;
+        static constexpr std::uint64_t mask = std::numeric_limits<std::uint64_t>::max() >> (64 - width);
+        static constexpr std::uint64_t sign = std::uint64_t{1} << (width - 1);
+
+        static std::uint64_t negate(std::uint64_t const value) noexcept
+        {
+            return (~value + 1) & mask;
+        }
+        static std::uint64_t invert(std::uint64_t const value) noexcept
+        {
+            return ~value & mask;
+        }
+
+        static std::uint64_t add(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return (value_1 + value_2) & mask;
+        }
+        static std::uint64_t subtract(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return (value_1 - value_2) & mask;
+        }
+        static std::uint64_t multiply(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return (value_1 * value_2) & mask;
+        }
+        static std::uint64_t divide(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            if constexpr (std::is_signed_v<T>)
+            {
+                // bvsdiv
+                auto const negative_1 = (value_1 & sign) != 0;
+                auto const negative_2 = (value_2 & sign) != 0;
+                auto const quotient = divide_unsigned(negative_1 ? negate(value_1) : value_1, negative_2 ? negate(value_2) : value_2);
+
+                return negative_1 != negative_2 ? negate(quotient) : quotient;
+            }
+            else
+            {
+                return divide_unsigned(value_1, value_2);
+            }
+        }
+        static std::uint64_t remainder(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            if constexpr (std::is_signed_v<T>)
+            {
+                // bvsrem (sign follows the dividend)
+                auto const negative_1 = (value_1 & sign) != 0;
+                auto const negative_2 = (value_2 & sign) != 0;
+                auto const remainder = remainder_unsigned(negative_1 ? negate(value_1) : value_1, negative_2 ? negate(value_2) : value_2);
+
+                return negative_1 ? negate(remainder) : remainder;
+            }
+            else
+            {
+                return remainder_unsigned(value_1, value_2);
+            }
+        }
+        static std::uint64_t bitwise_and(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_1 & value_2;
+        }
+        static std::uint64_t bitwise_or(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_1 | value_2;
+        }
+        static std::uint64_t bitwise_xor(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_1 ^ value_2;
+        }
+        static std::uint64_t shift_left(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_2 >= width ? 0 : (value_1 << value_2) & mask;
+        }
+        static std::uint64_t shift_right(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            // bvlshr
+            return value_2 >= width ? 0 : value_1 >> value_2;
+        }
+
+        static bool equal(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_1 == value_2;
+        }
+        static bool less(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            if constexpr (std::is_signed_v<T>)
+                return (value_1 ^ sign) < (value_2 ^ sign);
+            else
+                return value_1 < value_2;
+        }
+
+    private:
+        static std::uint64_t divide_unsigned(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            // Division by zero yields all ones
+            return value_2 == 0 ? mask : value_1 / value_2;
+        }
+        static std::uint64_t remainder_unsigned(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            // Division by zero yields the dividend
+            return value_2 == 0 ? value_1 : value_1 % value_2;
+        }
+    };
+
+    // Native Boolean operations on the bits of constant Boolean expressions
+    struct boolean_logic
+    {
+        static bool conjunction(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_1 != 0 && value_2 != 0;
+        }
+        static bool disjunction(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_1 != 0 || value_2 != 0;
+        }
+        static bool exclusive_disjunction(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return (value_1 != 0) != (value_2 != 0);
+        }
+        static bool equivalence(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return (value_1 != 0) == (value_2 != 0);
+        }
+        static bool implication(std::uint64_t const value_1, std::uint64_t const value_2) noexcept
+        {
+            return value_1 == 0 || value_2 != 0;
+        }
+    };
+
+    static z3_func_decl indirection(z3_context const& context, z3_sort const& pointer_sort)
+    {
+        auto* const pointer_sort_resource = static_cast<_Z3_sort*>(pointer_sort);
+
+        return z3_func_decl(context, Z3_mk_func_decl, indirection_symbol, 1U, &pointer_sort_resource, z3_sort(context, Z3_mk_bv_sort, unsigned{CHAR_BIT}));
+    }
+
+    // Visits every distinct application within a term once, descending into its arguments as long as the visitor returns true
+    template <std::invocable<z3_ast const&, z3_app const&> Visitor>
+    static void traverse(z3_ast const& root, Visitor const& visitor) noexcept
+    {
+        auto const& context = root.context();
+
+        std::unordered_set<unsigned> visited;
+
+        std::vector<z3_ast> pending{root};
+        while (!pending.empty())
+        {
+            auto const term = std::move(pending.back());
+            pending.pop_back();
+
+            if (!visited.insert(term.apply(Z3_get_ast_id)).second || term.apply(Z3_get_ast_kind) != Z3_APP_AST)
+                continue;
+
+            z3_app const application(context, Z3_to_app, term);
+            if (!visitor(term, application))
+                continue;
+
+            auto const argument_count = application.apply(Z3_get_app_num_args);
+            for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+                pending.emplace_back(context, Z3_get_app_arg, application, argument_index);
+        }
+    }
+
+    template <typename T>
+    expression<T> translate(expression<T> const& value)
+    {
+        return translate(value, expression_context::current());
+    }
+    template <typename T>
+    expression<T> translate(expression<T> const& value, expression_context const& context)
+    {
+        auto const& source = value.base_.context();
+        auto const& target = z3_context::instance(context);
+        if (&source == &target)
+            return value;
+
+        if (value.concrete_)
+        {
+            auto translated = value;
+
+            // Build the term on demand within the target context
+            translated.base_ = z3_ast(target, nullptr);
+
+            return translated;
+        }
+
+        expression<T> translated(
+            z3_ast(
+                target,
+                [&source](_Z3_context* const target_resource, _Z3_ast* const resource)
+                {
+                    return Z3_translate(source, resource, target_resource);
+                },
+                value.base_));
+        translated.simplification_pending_ = value.simplification_pending_;
+
+        return translated;
+    }
 
     template <typename T>
     expression<T> parse_expression(std::string const& string)
     {
+        return parse_expression<T>(expression_context::current(), string);
+    }
+    template <typename T>
+    expression<T> parse_expression(expression_context const& context, std::string const& string)
+    {
+        auto const& base_context = z3_context::instance(context);
+
         // TODO: Reset error handler
-        z3_ast_vector parsed_string(Z3_parse_smtlib2_string, string.c_str(), 0U, nullptr, nullptr, 0U, nullptr, nullptr);
+        z3_ast_vector parsed_string(base_context, Z3_parse_smtlib2_string, string.c_str(), 0U, nullptr, nullptr, 0U, nullptr, nullptr);
         if (parsed_string.apply(Z3_ast_vector_size) != 1)
             throw std::invalid_argument("Parsing error");
 
-        z3_ast ast(Z3_ast_vector_get, parsed_string, 0U);
+        z3_ast ast(base_context, Z3_ast_vector_get, parsed_string, 0U);
         if constexpr (std::same_as<T, bool>)
         {
-            if (z3_sort(Z3_get_sort, ast).apply(Z3_get_sort_kind) != Z3_BOOL_SORT)
+            if (z3_sort(base_context, Z3_get_sort, ast).apply(Z3_get_sort_kind) != Z3_BOOL_SORT)
                 throw std::invalid_argument("Parsing error");
         }
         else if constexpr (!std::same_as<T, void>)
         {
-            if (z3_sort(Z3_get_sort, ast).apply(Z3_get_bv_sort_size) / CHAR_BIT != sizeof(T))
+            if (z3_sort(base_context, Z3_get_sort, ast).apply(Z3_get_bv_sort_size) / CHAR_BIT != sizeof(T))
                 throw std::invalid_argument("Parsing error");
         }
 
@@ -66,8 +286,17 @@ namespace fml
         return stream;
     }
 
+    // Plain handle without any further indirection
+    static_assert(!std::has_virtual_destructor_v<expression<>>);
+
     expression<>::expression(z3_ast base) noexcept :
-        base_(std::make_unique<z3_ast>(std::move(base)))
+        base_(std::move(base))
+    { }
+    expression<>::expression(z3_context const& context, std::size_t const size, std::uint64_t const value) noexcept :
+        base_(context, nullptr),
+        value_(value),
+        size_(static_cast<std::uint8_t>(size)),
+        concrete_(true)
     { }
 
     expression<>::~expression() noexcept = default;
@@ -79,9 +308,7 @@ namespace fml
     {
         static_assert(sizeof(expression<T>) == sizeof(expression));
     }
-    expression<>::expression(expression const& other) noexcept :
-        base_(std::make_unique<z3_ast>(*other.base_))
-    { }
+    expression<>::expression(expression const&) noexcept = default;
     template <integral_expression_typename T>
     expression<>& expression<>::operator=(expression<T> const& other) noexcept
     {
@@ -90,13 +317,7 @@ namespace fml
         // NOLINTNEXTLINE [cppcoreguidelines-pro-type-reinterpret-cast]
         return operator=(reinterpret_cast<expression const&>(other));
     }
-    expression<>& expression<>::operator=(expression const& other) noexcept
-    {
-        if (&other != this)
-            base_ = std::make_unique<z3_ast>(*other.base_);
-
-        return *this;
-    }
+    expression<>& expression<>::operator=(expression const&) noexcept = default;
 
     template <integral_expression_typename T>
     expression<>::expression(expression<T>&& other) noexcept :
@@ -141,19 +362,33 @@ namespace fml
 
     bool expression<>::operator==(expression const& other) const noexcept
     {
-        return base_->apply(Z3_is_eq_ast, *other.base_);
+        if (concrete_ && other.concrete_)
+            return size_ == other.size_ && value_ == other.value_;
+
+        observe();
+        other.observe();
+
+        return base().apply(Z3_is_eq_ast, other.base());
     }
 
     bool expression<>::conclusive() const noexcept
     {
-        return base_->apply(Z3_is_numeral_ast);
+        // Like with terms, only numerals count (not Boolean values)
+        if (concrete_)
+            return size_ != 0;
+
+        observe();
+
+        return base_.apply(Z3_is_numeral_ast);
     }
 
     std::string expression<>::representation() const noexcept
     {
         static std::regex const regex_line_break(R"(\n *)");
 
-        std::string string(base_->apply(Z3_ast_to_string));
+        observe();
+
+        std::string string(base().apply(Z3_ast_to_string));
 
         // Remove line breaks
         string = std::regex_replace(string, regex_line_break, " ");
@@ -167,7 +402,12 @@ namespace fml
         if (sizeof(T) != size())
             throw std::logic_error("Invalid width");
 
-        if (std::uint64_t value{}; base_->apply(Z3_get_numeral_uint64, &value))
+        if (concrete_)
+            return static_cast<T>(value_);
+
+        observe();
+
+        if (std::uint64_t value{}; base_.apply(Z3_get_numeral_uint64, &value))
             return static_cast<T>(value);
 
         throw std::logic_error("Inconclusive evaluation");
@@ -175,96 +415,234 @@ namespace fml
 
     std::unordered_set<std::string> expression<>::dependencies() const noexcept
     {
-        z3_app base_application(Z3_to_app, *base_);
+        std::unordered_set<std::string> dependencies;
+        for (auto const id : dependency_ids())
+            dependencies.insert(symbol_name(id));
 
-        auto const argument_count = base_application.apply(Z3_get_app_num_args);
-        if (argument_count == 0 && !conclusive())
-        {
-            // Dependency by itself
-            return {z3_symbol(Z3_get_decl_name, z3_func_decl(Z3_get_app_decl, base_application)).apply(Z3_get_symbol_string)};
-        }
+        return dependencies;
+    }
+    std::vector<symbol_id> expression<>::dependency_ids() const noexcept
+    {
+        if (concrete_)
+            return {};
 
-        std::unordered_set<std::string> dependencies;
-        for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
-        {
-            expression const child(z3_ast(Z3_get_app_arg, base_application, argument_index));
+        observe();
 
-            // Recurse
-            dependencies.merge(child.dependencies());
-        }
+        auto const& context = base_.context();
+
+        if (auto const* const cached_dependencies = context.find_dependencies(base_); cached_dependencies != nullptr)
+            return *cached_dependencies;
+
+        std::vector<symbol_id> dependencies;
+        std::vector<_Z3_symbol*> dependency_symbols;
+        traverse(base_,
+            [&context, &dependencies, &dependency_symbols](z3_ast const& term, z3_app const& application)
+            {
+                // Reuse what is known about subterms (e.g. operands)
+                if (auto const* const cached_dependencies = context.find_dependencies(term); cached_dependencies != nullptr)
+                {
+                    dependencies.insert(dependencies.end(), cached_dependencies->begin(), cached_dependencies->end());
+                    return false;
+                }
+
+                if (application.apply(Z3_get_app_num_args) != 0)
+                    return true;
+
+                // Constants other than numerals and Boolean values
+                z3_func_decl const declaration(context, Z3_get_app_decl, application);
+                if (declaration.apply(Z3_get_decl_kind) == Z3_OP_UNINTERPRETED)
+                    dependency_symbols.push_back(declaration.apply(Z3_get_decl_name));
+
+                return false;
+            });
+
+        z3_symbol_table::instance().intern(context, dependency_symbols, dependencies);
+
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+        context.store_dependencies(base_, dependencies);
 
         return dependencies;
     }
     std::unordered_set<expression<>> expression<>::dependencies_indirect() const noexcept
     {
-        z3_app base_application(Z3_to_app, *base_);
+        if (concrete_)
+            return {};
 
-        auto const argument_count = base_application.apply(Z3_get_app_num_args);
-        if (argument_count == 1 && z3_func_decl(Z3_get_app_decl, base_application).apply(Z3_get_decl_name) == indirection_symbol)
-        {
-            // Dependency by itself
-            return {expression(z3_ast(Z3_get_app_arg, base_application, 0U))};
-        }
+        observe();
+
+        auto const& context = base_.context();
 
         std::unordered_set<expression> dependencies;
-        for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
-        {
-            expression const child(z3_ast(Z3_get_app_arg, base_application, argument_index));
+        traverse(base_,
+            [&context, &dependencies](z3_ast const& /*term*/, z3_app const& application)
+            {
+                if (application.apply(Z3_get_app_num_args) != 1 || z3_func_decl(context, Z3_get_app_decl, application).apply(Z3_get_decl_name) != indirection_symbol)
+                    return true;
 
-            // Recurse
-            dependencies.merge(child.dependencies_indirect());
-        }
+                // Pointers are not searched for further indirections
+                dependencies.insert(expression(z3_ast(context, Z3_get_app_arg, application, 0U)));
+
+                return false;
+            });
 
         return dependencies;
     }
 
     void expression<>::substitute(std::string const& key_symbol, expression const& value) noexcept
     {
-        expression const key(
-            z3_ast(
-                Z3_mk_const,
-                z3_symbol(
-                    Z3_mk_string_symbol,
-                    key_symbol.c_str()),
-                z3_sort(Z3_get_sort, *value.base_)));
+        substitute({{key_symbol, value}});
+    }
+    void expression<>::substitute(std::unordered_map<std::string, expression> const& values) noexcept
+    {
+        if (concrete_ || values.empty())
+            return;
 
-        auto* const key_resource = static_cast<_Z3_ast*>(*key.base_);
-        auto* const value_resource = static_cast<_Z3_ast*>(*value.base_);
+        auto const& context = base_.context();
 
-        base_->update_self(Z3_substitute, 1U, &key_resource, &value_resource);
-        base_->update_self(Z3_simplify);
+        std::vector<z3_ast> keys;
+        keys.reserve(values.size());
+        std::vector<_Z3_ast*> key_resources;
+        key_resources.reserve(values.size());
+        std::vector<_Z3_ast*> value_resources;
+        value_resources.reserve(values.size());
+        for (auto const& [key_symbol, value] : values)
+        {
+            key_resources.push_back(
+                keys.emplace_back(
+                    context,
+                    Z3_mk_const,
+                    z3_symbol(
+                        context,
+                        Z3_mk_string_symbol,
+                        key_symbol.c_str()),
+                    z3_sort(context, Z3_get_sort, value.base())));
+            value_resources.push_back(value.base());
+        }
+
+        // Single pass over the term
+        base_.update_self(Z3_substitute, static_cast<unsigned>(values.size()), key_resources.data(), value_resources.data());
+        simplify();
     }
     void expression<>::substitute_indirect(expression const& key_pointer, expression<std::byte> const& value) noexcept
     {
-        z3_sort const key_pointer_sort(Z3_get_sort, *key_pointer.base_);
+        substitute_indirect({{key_pointer, value}});
+    }
+    void expression<>::substitute_indirect(std::unordered_map<expression, expression<std::byte>> const& values) noexcept
+    {
+        if (concrete_ || values.empty())
+            return;
 
-        auto* const key_pointer_resource = static_cast<_Z3_ast*>(*key_pointer.base_);
-        auto* const key_pointer_sort_resource = static_cast<_Z3_sort*>(key_pointer_sort);
+        auto const& context = base_.context();
 
-        expression<std::byte> const key(
-            z3_ast(
-                Z3_mk_app,
-                z3_func_decl(
-                    Z3_mk_func_decl,
-                    indirection_symbol,
-                    1U,
-                    &key_pointer_sort_resource,
-                    z3_sort(
-                        Z3_mk_bv_sort,
-                        unsigned{CHAR_BIT})),
-                1U,
-                &key_pointer_resource));
+        std::vector<z3_ast> keys;
+        keys.reserve(values.size());
+        std::vector<_Z3_ast*> key_resources;
+        key_resources.reserve(values.size());
+        std::vector<_Z3_ast*> value_resources;
+        value_resources.reserve(values.size());
+        for (auto const& [key_pointer, value] : values)
+        {
+            auto* const key_pointer_resource = static_cast<_Z3_ast*>(key_pointer.base());
 
-        auto* const key_resource = static_cast<_Z3_ast*>(*key.base_);
-        auto* const value_resource = static_cast<_Z3_ast*>(*value.base_);
+            key_resources.push_back(
+                keys.emplace_back(
+                    context,
+                    Z3_mk_app,
+                    indirection(context, z3_sort(context, Z3_get_sort, key_pointer.base())),
+                    1U,
+                    &key_pointer_resource));
+            value_resources.push_back(value.base());
+        }
 
-        base_->update_self(Z3_substitute, 1U, &key_resource, &value_resource);
-        base_->update_self(Z3_simplify);
+        // Single pass over the term
+        base_.update_self(Z3_substitute, static_cast<unsigned>(values.size()), key_resources.data(), value_resources.data());
+        simplify();
     }
 
     std::size_t expression<>::size() const noexcept
     {
-        return z3_sort(Z3_get_sort, *base_).apply(Z3_get_bv_sort_size) / CHAR_BIT;
+        if (concrete_)
+            return size_;
+
+        return z3_sort(base_.context(), Z3_get_sort, base_).apply(Z3_get_bv_sort_size) / CHAR_BIT;
+    }
+
+    z3_ast const& expression<>::base() const noexcept
+    {
+        if (concrete_ && static_cast<_Z3_ast*>(base_) == nullptr)
+        {
+            if (size_ == 0)
+                base_.update(value_ == 0 ? Z3_mk_false : Z3_mk_true);
+            else
+                base_.update(Z3_mk_unsigned_int64, value_, z3_sort(base_.context(), Z3_mk_bv_sort, static_cast<unsigned>(size_ * CHAR_BIT)));
+        }
+
+        return base_;
+    }
+    z3_ast& expression<>::base_symbolic() noexcept
+    {
+        static_cast<void>(base());
+        concrete_ = false;
+
+        return base_;
+    }
+
+    std::optional<std::uint64_t> expression<>::value() const noexcept
+    {
+        if (concrete_)
+            return value_;
+
+        // Terms may have been simplified to constants
+        if (std::uint64_t bits{}; base_.apply(Z3_is_numeral_ast) && base_.apply(Z3_get_numeral_uint64, &bits))
+            return bits;
+
+        switch (base_.apply(Z3_get_bool_value))
+        {
+        case Z3_L_FALSE:
+            return 0;
+        case Z3_L_TRUE:
+            return 1;
+
+        default:
+            return std::nullopt;
+        }
+    }
+
+    template <typename Result>
+    std::optional<Result> expression<>::fold(expression const& value_1, expression const& value_2, Result (*const operation)(std::uint64_t, std::uint64_t)) noexcept
+    {
+        if (auto const constant_1 = value_1.value(); constant_1.has_value())
+        {
+            if (auto const constant_2 = value_2.value(); constant_2.has_value())
+                return operation(*constant_1, *constant_2);
+        }
+
+        return std::nullopt;
+    }
+
+    void expression<>::simplify() noexcept
+    {
+        if (concrete_)
+            return;
+
+        if (base_.context().selected_simplification_mode() == simplification_mode::lazy)
+        {
+            simplification_pending_ = true;
+            return;
+        }
+
+        base_.update_self(Z3_simplify);
+        simplification_pending_ = false;
+    }
+    void expression<>::observe() const noexcept
+    {
+        if (!simplification_pending_)
+            return;
+
+        base_.update_self(Z3_simplify);
+        simplification_pending_ = false;
     }
 
     expression<bool>::expression(z3_ast base) noexcept :
@@ -272,40 +650,54 @@ namespace fml
     { }
 
     expression<bool>::expression(bool const value) noexcept :
-        expression(z3_ast(value ? Z3_mk_true : Z3_mk_false))
+        expression(expression_context::current(), value)
+    { }
+    expression<bool>::expression(expression_context const& context, bool const value) noexcept :
+        expression(z3_context::instance(context), value)
+    { }
+    expression<bool>::expression(z3_context const& context, bool const value) noexcept :
+        expression<>(context, 0, value ? 1 : 0)
     { }
 
     expression<bool> expression<bool>::symbol(std::string const& symbol)
     {
-        auto const contains_space_or_unprint = std::any_of(symbol.begin(), symbol.end(),
-            [](char const c)
-            {
-                return c == ' ' || std::isprint(c) == 0;
-            });
-
-        // TODO: Remove this and (possibly) more duplicated code
-        if (contains_space_or_unprint || symbol.empty() || std::isdigit(symbol.front()) != 0)
-            throw std::invalid_argument("Invalid symbol");
+        return expression::symbol(expression_context::current(), symbol);
+    }
+    expression<bool> expression<bool>::symbol(expression_context const& context, std::string const& symbol)
+    {
+        return expression::symbol(context, z3_symbol_table::instance().intern(z3_context::instance(context), symbol));
+    }
+    expression<bool> expression<bool>::symbol(symbol_id const symbol)
+    {
+        return expression::symbol(expression_context::current(), symbol);
+    }
+    expression<bool> expression<bool>::symbol(expression_context const& context, symbol_id const symbol)
+    {
+        auto const& base_context = z3_context::instance(context);
 
         return expression(
             z3_ast(
+                base_context,
                 Z3_mk_const,
-                z3_symbol(
-                    Z3_mk_string_symbol,
-                    symbol.c_str()),
-                z3_sort(Z3_mk_bool_sort)));
+                z3_symbol_table::instance().symbol(symbol),
+                z3_sort(base_context, Z3_mk_bool_sort)));
     }
 
     template <integral_expression_typename T>
     expression<bool>::expression(expression<T> const& other) :
-        expression(!other.equals(zero<T>))
+        expression(!other.equals(expression<T>(other.base_.context(), T{})))
     {
-        base_->update_self(Z3_simplify);
+        simplify();
     }
 
     bool expression<bool>::evaluate() const
     {
-        switch (base_->apply(Z3_get_bool_value))
+        if (concrete_)
+            return value_ != 0;
+
+        observe();
+
+        switch (base_.apply(Z3_get_bool_value))
         {
         case Z3_L_FALSE:
             return false;
@@ -319,69 +711,92 @@ namespace fml
 
     void expression<bool>::reduce()
     {
-        z3_goal reduction_goal(Z3_mk_goal, false, false, false);
-        reduction_goal.apply(Z3_goal_assert, *base_);
+        if (concrete_)
+            return;
+
+        auto const& context = base_.context();
+
+        z3_goal reduction_goal(context, Z3_mk_goal, false, false, false);
+        reduction_goal.apply(Z3_goal_assert, base_);
         reduction_goal.update(
             Z3_apply_result_get_subgoal,
-            z3_apply_result(Z3_tactic_apply, z3_tactic(Z3_mk_tactic, "ctx-simplify"), reduction_goal),
+            z3_apply_result(context, Z3_tactic_apply, z3_tactic(context, Z3_mk_tactic, "ctx-simplify"), reduction_goal),
             0U);
 
-        base_->update(Z3_mk_true);
+        base_.update(Z3_mk_true);
         auto const reduction_goal_size = reduction_goal.apply(Z3_goal_size);
         for (auto index = 0U; index < reduction_goal_size; ++index)
         {
-            z3_ast formula(Z3_goal_formula, reduction_goal, index);
+            z3_ast formula(context, Z3_goal_formula, reduction_goal, index);
 
-            std::array<_Z3_ast*, 2> const arguments{*base_, formula};
-            base_->update(Z3_mk_and, static_cast<unsigned>(arguments.size()), arguments.data());
+            std::array<_Z3_ast*, 2> const arguments{base_, formula};
+            base_.update(Z3_mk_and, static_cast<unsigned>(arguments.size()), arguments.data());
         }
-        base_->update_self(Z3_simplify);
+        simplify();
     }
 
     expression<bool> expression<bool>::operator!() const noexcept
     {
+        if (auto const constant = value(); constant.has_value())
+            return expression(base_.context(), *constant == 0);
+
         auto copy = *this;
-        copy.base_->update_self(Z3_mk_not);
-        copy.base_->update_self(Z3_simplify);
+        copy.base_symbolic().update_self(Z3_mk_not);
+        copy.simplify();
 
         return copy;
     }
 
     expression<bool> expression<bool>::equals(expression const& other) const noexcept
     {
-        z3_ast derived(Z3_mk_eq, *base_, *other.base_);
-        derived.update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, boolean_logic::equivalence); folded.has_value())
+            return expression(base_.context(), *folded);
+
+        expression derived(z3_ast(base_.context(), Z3_mk_eq, base(), other.base()));
+        derived.simplify();
 
-        return expression(std::move(derived));
+        return derived;
     }
     expression<bool> expression<bool>::implies(expression const& other) const noexcept
     {
-        z3_ast derived(Z3_mk_implies, *base_, *other.base_);
-        derived.update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, boolean_logic::implication); folded.has_value())
+            return expression(base_.context(), *folded);
 
-        return expression(std::move(derived));
+        expression derived(z3_ast(base_.context(), Z3_mk_implies, base(), other.base()));
+        derived.simplify();
+
+        return derived;
     }
 
     expression<bool>& expression<bool>::operator&=(expression const& other) noexcept
     {
-        std::array<_Z3_ast*, 2> const arguments{*base_, *other.base_};
-        base_->update(Z3_mk_and, static_cast<unsigned>(arguments.size()), arguments.data());
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, boolean_logic::conjunction); folded.has_value())
+            return *this = expression(base_.context(), *folded);
+
+        std::array<_Z3_ast*, 2> const arguments{base(), other.base()};
+        base_symbolic().update(Z3_mk_and, static_cast<unsigned>(arguments.size()), arguments.data());
+        simplify();
 
         return *this;
     }
     expression<bool>& expression<bool>::operator|=(expression const& other) noexcept
     {
-        std::array<_Z3_ast*, 2> const arguments{*base_, *other.base_};
-        base_->update(Z3_mk_or, static_cast<unsigned>(arguments.size()), arguments.data());
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, boolean_logic::disjunction); folded.has_value())
+            return *this = expression(base_.context(), *folded);
+
+        std::array<_Z3_ast*, 2> const arguments{base(), other.base()};
+        base_symbolic().update(Z3_mk_or, static_cast<unsigned>(arguments.size()), arguments.data());
+        simplify();
 
         return *this;
     }
     expression<bool>& expression<bool>::operator^=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_xor, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, boolean_logic::exclusive_disjunction); folded.has_value())
+            return *this = expression(base_.context(), *folded);
+
+        base_symbolic().update_self(Z3_mk_xor, other.base());
+        simplify();
 
         return *this;
     }
@@ -402,18 +817,24 @@ namespace fml
     template <integral_expression_typename T>
     expression<T> expression<T>::operator-() const noexcept
     {
+        if (auto const constant = value(); constant.has_value())
+            return expression(base_.context(), static_cast<T>(numeral_arithmetic<T>::negate(*constant)));
+
         auto copy = *this;
-        copy.base_->update_self(Z3_mk_bvneg);
-        copy.base_->update_self(Z3_simplify);
+        copy.base_symbolic().update_self(Z3_mk_bvneg);
+        copy.simplify();
 
         return copy;
     }
     template <integral_expression_typename T>
     expression<T> expression<T>::operator~() const noexcept
     {
+        if (auto const constant = value(); constant.has_value())
+            return expression(base_.context(), static_cast<T>(numeral_arithmetic<T>::invert(*constant)));
+
         auto copy = *this;
-        copy.base_->update_self(Z3_mk_bvnot);
-        copy.base_->update_self(Z3_simplify);
+        copy.base_symbolic().update_self(Z3_mk_bvnot);
+        copy.simplify();
 
         return copy;
     }
@@ -425,58 +846,96 @@ namespace fml
 
     template <integral_expression_typename T>
     expression<T>::expression(T const value) noexcept :
-        expression(z3_ast(Z3_mk_unsigned_int64, static_cast<std::uint64_t>(value), z3_sort(Z3_mk_bv_sort, static_cast<unsigned>(sizeof(T) * CHAR_BIT))))
+        expression(expression_context::current(), value)
+    { }
+    template <integral_expression_typename T>
+    expression<T>::expression(expression_context const& context, T const value) noexcept :
+        expression(z3_context::instance(context), value)
+    { }
+    template <integral_expression_typename T>
+    expression<T>::expression(z3_context const& context, T const value) noexcept :
+        expression<>(context, sizeof(T), static_cast<std::uint64_t>(value) & numeral_arithmetic<T>::mask)
     { }
 
     template <integral_expression_typename T>
     expression<T> expression<T>::symbol(std::string const& symbol)
     {
-        auto const contains_space_or_unprint = std::any_of(symbol.begin(), symbol.end(),
-            [](char const c)
-            {
-                return c == ' ' || std::isprint(c) == 0;
-            });
-
-        if (contains_space_or_unprint || symbol.empty() || std::isdigit(symbol.front()) != 0)
-            throw std::invalid_argument("Invalid symbol");
+        return expression::symbol(expression_context::current(), symbol);
+    }
+    template <integral_expression_typename T>
+    expression<T> expression<T>::symbol(expression_context const& context, std::string const& symbol)
+    {
+        return expression::symbol(context, z3_symbol_table::instance().intern(z3_context::instance(context), symbol));
+    }
+    template <integral_expression_typename T>
+    expression<T> expression<T>::symbol(symbol_id const symbol)
+    {
+        return expression::symbol(expression_context::current(), symbol);
+    }
+    template <integral_expression_typename T>
+    expression<T> expression<T>::symbol(expression_context const& context, symbol_id const symbol)
+    {
+        auto const& base_context = z3_context::instance(context);
 
         return expression(
             z3_ast(
+                base_context,
                 Z3_mk_const,
-                z3_symbol(
-                    Z3_mk_string_symbol,
-                    symbol.c_str()),
-                z3_sort(Z3_mk_bv_sort, static_cast<unsigned>(sizeof(T) * CHAR_BIT))));
+                z3_symbol_table::instance().symbol(symbol),
+                z3_sort(base_context, Z3_mk_bv_sort, static_cast<unsigned>(sizeof(T) * CHAR_BIT))));
     }
 
     template <integral_expression_typename T>
     expression<T>::expression(expression<bool> const& other) noexcept :
-        expression(*other.base_)
+        expression(other.base_.context(), T{})
     {
-        base_->update_self(Z3_mk_ite, *one<T>.base_, *zero<T>.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const constant = other.value(); constant.has_value())
+        {
+            value_ = *constant;
+            return;
+        }
+
+        auto const& context = base_.context();
+
+        base_ = z3_ast(context, Z3_mk_ite, other.base_, numeral(context, static_cast<T>(1)), numeral(context, static_cast<T>(0)));
+        concrete_ = false;
+        simplify();
     }
 
     template <integral_expression_typename T>
     template <integral_expression_typename U>
     expression<T>::expression(expression<U> const& other) noexcept requires(sizeof(U) == sizeof(T)) :
-        expression(*other.base_)
+        expression<>(static_cast<expression<> const&>(other))
     { }
     template <integral_expression_typename T>
     template <integral_expression_typename U>
     expression<T>::expression(expression<U> const& other) noexcept requires(sizeof(U) > sizeof(T)) :
-        expression(*other.base_)
+        expression(other.base_.context(), T{})
     {
-        base_->update(Z3_mk_extract, unsigned{sizeof(T) * CHAR_BIT - 1}, unsigned{0}, *base_);
-        base_->update_self(Z3_simplify);
+        if (auto const constant = other.value(); constant.has_value())
+        {
+            value_ = *constant & numeral_arithmetic<T>::mask;
+            return;
+        }
+
+        base_ = z3_ast(base_.context(), Z3_mk_extract, unsigned{sizeof(T) * CHAR_BIT - 1}, unsigned{0}, other.base_);
+        concrete_ = false;
+        simplify();
     }
     template <integral_expression_typename T>
     template <integral_expression_typename U>
     expression<T>::expression(expression<U> const& other) noexcept requires(sizeof(U) < sizeof(T)) :
-        expression(*other.base_)
+        expression(other.base_.context(), T{})
     {
-        base_->update(Z3_mk_zero_ext, unsigned{(sizeof(T) - sizeof(U)) * CHAR_BIT}, *base_);
-        base_->update_self(Z3_simplify);
+        if (auto const constant = other.value(); constant.has_value())
+        {
+            value_ = *constant;
+            return;
+        }
+
+        base_ = z3_ast(base_.context(), Z3_mk_zero_ext, unsigned{(sizeof(T) - sizeof(U)) * CHAR_BIT}, other.base_);
+        concrete_ = false;
+        simplify();
     }
 
     template <integral_expression_typename T>
@@ -489,12 +948,24 @@ namespace fml
         }
         else
         {
+            // Most significant part last
+            std::optional<std::uint64_t> joined(0);
+            for (auto part = parts.rbegin(); part != parts.rend() && joined.has_value(); ++part)
+            {
+                if (auto const constant = part->value(); constant.has_value())
+                    joined = *joined << (sizeof(U) * CHAR_BIT) | *constant;
+                else
+                    joined.reset();
+            }
+            if (joined.has_value())
+                return expression(std::get<0>(parts).base_.context(), static_cast<T>(*joined));
+
             auto result = concatenate<T, sizeof(T) / sizeof(U)>(
                 [&parts]<std::size_t INDEX>()
                 {
                     return std::get<INDEX>(parts);
                 });
-            result.base_->update_self(Z3_simplify);
+            result.simplify();
 
             return result;
         }
@@ -503,16 +974,24 @@ namespace fml
     template <integral_expression_typename U, std::size_t POSITION>
     expression<U> expression<T>::extract() const noexcept requires(sizeof(T) >= sizeof(U) * (POSITION + 1))
     {
-        z3_ast derived(Z3_mk_extract, unsigned{(sizeof(U) * CHAR_BIT * (POSITION + 1)) - 1}, unsigned{sizeof(U) * CHAR_BIT * POSITION}, *base_);
-        derived.update_self(Z3_simplify);
+        if (auto const constant = value(); constant.has_value())
+            return expression<U>(base_.context(), static_cast<U>(*constant >> (sizeof(U) * CHAR_BIT * POSITION)));
 
-        return expression<U>(std::move(derived));
+        expression<U> derived(z3_ast(base_.context(), Z3_mk_extract, unsigned{(sizeof(U) * CHAR_BIT * (POSITION + 1)) - 1}, unsigned{sizeof(U) * CHAR_BIT * POSITION}, base_));
+        derived.simplify();
+
+        return derived;
     }
 
     template <integral_expression_typename T>
     T expression<T>::evaluate() const
     {
-        if (std::uint64_t value{}; base_->apply(Z3_get_numeral_uint64, &value))
+        if (concrete_)
+            return static_cast<T>(value_);
+
+        observe();
+
+        if (std::uint64_t value{}; base_.apply(Z3_get_numeral_uint64, &value))
             return static_cast<T>(value);
 
         throw std::logic_error("Inconclusive evaluation");
@@ -522,28 +1001,27 @@ namespace fml
     template <integral_expression_typename U>
     expression<U> expression<T>::dereference() const noexcept
     {
-        static z3_sort const indirection_sort(Z3_mk_bv_sort, static_cast<unsigned>(sizeof(T) * CHAR_BIT));
-        // NOLINTNEXTLINE [cppcoreguidelines-avoid-non-const-global-variables]
-        static auto* const indirection_sort_resource = static_cast<_Z3_sort*>(indirection_sort);
-        static z3_func_decl const indirection(Z3_mk_func_decl, indirection_symbol, 1U, &indirection_sort_resource, z3_sort(Z3_mk_bv_sort, unsigned{CHAR_BIT}));
+        auto const& context = base_.context();
+
+        z3_func_decl const indirection_declaration = indirection(context, z3_sort(context, Z3_mk_bv_sort, static_cast<unsigned>(sizeof(T) * CHAR_BIT)));
 
         if constexpr (sizeof(U) == 1)
         {
-            auto* const resource = static_cast<_Z3_ast*>(*base_);
+            auto* const resource = static_cast<_Z3_ast*>(base());
 
-            return expression<U>(z3_ast(Z3_mk_app, indirection, 1U, &resource));
+            return expression<U>(z3_ast(context, Z3_mk_app, indirection_declaration, 1U, &resource));
         }
         else
         {
             auto result = concatenate<U, sizeof(U)>(
-                [this]<std::size_t INDEX>()
+                [this, &context, &indirection_declaration]<std::size_t INDEX>()
                 {
-                    auto const advanced = *this + expression(static_cast<T>(INDEX));
-                    auto* const advanced_resource = static_cast<_Z3_ast*>(*advanced.base_);
+                    auto const advanced = *this + expression(context, static_cast<T>(INDEX));
+                    auto* const advanced_resource = static_cast<_Z3_ast*>(advanced.base());
 
-                    return expression<std::byte>(z3_ast(Z3_mk_app, indirection, 1U, &advanced_resource));
+                    return expression<std::byte>(z3_ast(context, Z3_mk_app, indirection_declaration, 1U, &advanced_resource));
                 });
-            result.base_->update_self(Z3_simplify);
+            result.simplify();
 
             return result;
         }
@@ -552,108 +1030,144 @@ namespace fml
     template <integral_expression_typename T>
     expression<bool> expression<T>::equals(expression const& other) const noexcept
     {
-        z3_ast derived(Z3_mk_eq, *base_, *other.base_);
-        derived.update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::equal); folded.has_value())
+            return expression<bool>(base_.context(), *folded);
 
-        return expression<bool>(std::move(derived));
+        expression<bool> derived(z3_ast(base_.context(), Z3_mk_eq, base(), other.base()));
+        derived.simplify();
+
+        return derived;
     }
     template <integral_expression_typename T>
     expression<bool> expression<T>::less_than(expression const& other) const noexcept
     {
-        z3_ast derived(std::is_signed_v<T> ? Z3_mk_bvslt : Z3_mk_bvult, *base_, *other.base_);
-        derived.update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::less); folded.has_value())
+            return expression<bool>(base_.context(), *folded);
+
+        expression<bool> derived(z3_ast(base_.context(), std::is_signed_v<T> ? Z3_mk_bvslt : Z3_mk_bvult, base(), other.base()));
+        derived.simplify();
 
-        return expression<bool>(std::move(derived));
+        return derived;
     }
 
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator++() noexcept
     {
-        return operator+=(one<T>);
+        return operator+=(expression(base_.context(), static_cast<T>(1)));
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator--() noexcept
     {
-        return operator-=(one<T>);
+        return operator-=(expression(base_.context(), static_cast<T>(1)));
     }
 
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator+=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvadd, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::add); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvadd, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator-=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvsub, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::subtract); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvsub, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator*=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvmul, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::multiply); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvmul, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator/=(expression const& other) noexcept
     {
-        base_->update_self(std::is_signed_v<T> ? Z3_mk_bvsdiv : Z3_mk_bvudiv, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::divide); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(std::is_signed_v<T> ? Z3_mk_bvsdiv : Z3_mk_bvudiv, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator%=(expression const& other) noexcept
     {
-        base_->update_self(std::is_signed_v<T> ? Z3_mk_bvsrem : Z3_mk_bvurem, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::remainder); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(std::is_signed_v<T> ? Z3_mk_bvsrem : Z3_mk_bvurem, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator&=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvand, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::bitwise_and); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvand, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator|=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvor, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::bitwise_or); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvor, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator^=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvxor, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::bitwise_xor); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvxor, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator<<=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvshl, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::shift_left); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvshl, other.base());
+        simplify();
 
         return *this;
     }
     template <integral_expression_typename T>
     expression<T>& expression<T>::operator>>=(expression const& other) noexcept
     {
-        base_->update_self(Z3_mk_bvlshr, *other.base_);
-        base_->update_self(Z3_simplify);
+        if (auto const folded = fold(*this, other, numeral_arithmetic<T>::shift_right); folded.has_value())
+            return *this = expression(base_.context(), static_cast<T>(*folded));
+
+        base_symbolic().update_self(Z3_mk_bvlshr, other.base());
+        simplify();
 
         return *this;
     }
@@ -669,14 +1183,14 @@ namespace fml
             // Recurse
             auto const previous = concatenate<U, COUNT - 1>(generator);
 
-            return expression<U>(z3_ast(Z3_mk_concat, *current.base_, *previous.base_));
+            return expression<U>(z3_ast(current.base_.context(), Z3_mk_concat, current.base(), previous.base()));
         }
         else
         {
             // Finalize
             auto const& previous = generator.template operator()<0>();
 
-            return expression<U>(z3_ast(Z3_mk_concat, *current.base_, *previous.base_));
+            return expression<U>(z3_ast(current.base_.context(), Z3_mk_concat, current.base(), previous.base()));
         }
     }
 
@@ -770,7 +1284,9 @@ namespace std // NOLINT [cert-dcl58-cpp]
 {
     size_t hash<fml::expression<>>::operator()(fml::expression<> const& expression) const noexcept
     {
-        return expression.base_->apply(Z3_get_ast_hash);
+        expression.observe();
+
+        return expression.base().apply(Z3_get_ast_hash);
     }
 
     size_t hash<fml::expression<bool>>::operator()(fml::expression<bool> const& expression) const noexcept
@@ -793,6 +1309,9 @@ namespace std // NOLINT [cert-dcl58-cpp]
 #define EXPRESSION(T) expression<TYPE(T)>
 
 template fml::expression<> fml::parse_expression(std::string const&);
+template fml::expression<> fml::parse_expression(expression_context const&, std::string const&);
+template fml::expression<> fml::translate(expression<> const&);
+template fml::expression<> fml::translate(expression<> const&, expression_context const&);
 
 template std::ostream& fml::operator<<(std::ostream&, expression<> const&);
 template std::wostream& fml::operator<<(std::wostream&, expression<> const&);
@@ -809,6 +1328,9 @@ template std::wostream& fml::operator<<(std::wostream&, expression<> const&);
 LOOP_TYPES_0(INSTANTIATE_ANONYMOUS_EXPRESSION);
 
 template fml::expression<bool> fml::parse_expression(std::string const&);
+template fml::expression<bool> fml::parse_expression(expression_context const&, std::string const&);
+template fml::expression<bool> fml::translate(expression<bool> const&);
+template fml::expression<bool> fml::translate(expression<bool> const&, expression_context const&);
 
 template std::ostream& fml::operator<<(std::ostream&, expression<bool> const&);
 template std::wostream& fml::operator<<(std::wostream&, expression<bool> const&);
@@ -830,6 +1352,9 @@ LOOP_TYPES_0(INSTANTIATE_BOOLEAN_EXPRESSION);
 // NOLINTNEXTLINE [cppcoreguidelines-macro-usage]
 #define INSTANTIATE_EXPRESSION(T) \
     template fml::EXPRESSION(T) fml::parse_expression(std::string const&); \
+    template fml::EXPRESSION(T) fml::parse_expression(expression_context const&, std::string const&); \
+    template fml::EXPRESSION(T) fml::translate(EXPRESSION(T) const&); \
+    template fml::EXPRESSION(T) fml::translate(EXPRESSION(T) const&, expression_context const&); \
     template std::ostream& fml::operator<<(std::ostream&, EXPRESSION(T) const&); \
     template std::wostream& fml::operator<<(std::wostream&, EXPRESSION(T) const&); \
     template fml::EXPRESSION(T) fml::operator+(EXPRESSION(T), EXPRESSION(T) const&); \
@@ -0,0 +1,1062 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <formulae1/expression_analysis.hpp>
+
+#include "preprocessor_types.hpp"
+#include "z3_resource.ipp"
+
+namespace fml
+{
+    using z3_app = z3_resource<_Z3_app>;
+    using z3_func_decl = z3_resource<_Z3_func_decl, _Z3_ast, Z3_inc_ref, Z3_dec_ref>;
+    using z3_sort = z3_resource<_Z3_sort, _Z3_ast, Z3_inc_ref, Z3_dec_ref>;
+
+    static constexpr unsigned max_width{64};
+
+    static std::uint64_t mask(unsigned const width) noexcept
+    {
+        return width >= max_width ? ~std::uint64_t{} : (std::uint64_t{1} << width) - 1;
+    }
+    static std::int64_t sign_extend(std::uint64_t const value, unsigned const width) noexcept
+    {
+        auto const shift = max_width - width;
+        return static_cast<std::int64_t>(value << shift) >> shift;
+    }
+
+    static expression_bounds top(unsigned const width) noexcept
+    {
+        return
+        {
+            .known_zeros = 0,
+            .known_ones = 0,
+            .unsigned_minimum = 0,
+            .unsigned_maximum = mask(width),
+            .signed_minimum = -static_cast<std::int64_t>(mask(width) >> 1U) - 1,
+            .signed_maximum = static_cast<std::int64_t>(mask(width) >> 1U)
+        };
+    }
+    static expression_bounds exact(std::uint64_t value, unsigned const width) noexcept
+    {
+        value &= mask(width);
+
+        return
+        {
+            .known_zeros = ~value & mask(width),
+            .known_ones = value,
+            .unsigned_minimum = value,
+            .unsigned_maximum = value,
+            .signed_minimum = sign_extend(value, width),
+            .signed_maximum = sign_extend(value, width)
+        };
+    }
+    static expression_bounds join(expression_bounds const& bounds_1, expression_bounds const& bounds_2) noexcept
+    {
+        return
+        {
+            .known_zeros = bounds_1.known_zeros & bounds_2.known_zeros,
+            .known_ones = bounds_1.known_ones & bounds_2.known_ones,
+            .unsigned_minimum = std::min(bounds_1.unsigned_minimum, bounds_2.unsigned_minimum),
+            .unsigned_maximum = std::max(bounds_1.unsigned_maximum, bounds_2.unsigned_maximum),
+            .signed_minimum = std::min(bounds_1.signed_minimum, bounds_2.signed_minimum),
+            .signed_maximum = std::max(bounds_1.signed_maximum, bounds_2.signed_maximum)
+        };
+    }
+
+    // Tightens the known bits and both ranges by one another
+    static expression_bounds refine(expression_bounds bounds, unsigned const width) noexcept
+    {
+        auto const value_mask = mask(width);
+        auto const sign = std::uint64_t{1} << (width - 1);
+
+        // One more round passes on what the first one has learned
+        for (auto round = 0; round < 2; ++round)
+        {
+            bounds.unsigned_minimum = std::max(bounds.unsigned_minimum, bounds.known_ones);
+            bounds.unsigned_maximum = std::min(bounds.unsigned_maximum, ~bounds.known_zeros & value_mask);
+
+            // Unknown signs make for the lowest negative and the highest positive value
+            auto const lowest = (bounds.known_zeros & sign) == 0 ? bounds.known_ones | sign : bounds.known_ones;
+            auto const highest = (bounds.known_ones & sign) == 0 ? ~bounds.known_zeros & value_mask & ~sign : ~bounds.known_zeros & value_mask;
+            bounds.signed_minimum = std::max(bounds.signed_minimum, sign_extend(lowest, width));
+            bounds.signed_maximum = std::min(bounds.signed_maximum, sign_extend(highest, width));
+
+            // Either range carries over to the other unless it spans both signs
+            if (bounds.unsigned_maximum < sign)
+            {
+                bounds.signed_minimum = std::max(bounds.signed_minimum, static_cast<std::int64_t>(bounds.unsigned_minimum));
+                bounds.signed_maximum = std::min(bounds.signed_maximum, static_cast<std::int64_t>(bounds.unsigned_maximum));
+            }
+            else if (bounds.unsigned_minimum >= sign)
+            {
+                bounds.signed_minimum = std::max(bounds.signed_minimum, sign_extend(bounds.unsigned_minimum, width));
+                bounds.signed_maximum = std::min(bounds.signed_maximum, sign_extend(bounds.unsigned_maximum, width));
+            }
+            if (bounds.signed_minimum >= 0 || bounds.signed_maximum < 0)
+            {
+                bounds.unsigned_minimum = std::max(bounds.unsigned_minimum, static_cast<std::uint64_t>(bounds.signed_minimum) & value_mask);
+                bounds.unsigned_maximum = std::min(bounds.unsigned_maximum, static_cast<std::uint64_t>(bounds.signed_maximum) & value_mask);
+            }
+
+            // Leading bits shared by all values within the unsigned range
+            auto const fixed = ~mask(static_cast<unsigned>(std::bit_width(bounds.unsigned_minimum ^ bounds.unsigned_maximum))) & value_mask;
+            bounds.known_zeros |= ~bounds.unsigned_minimum & fixed;
+            bounds.known_ones |= bounds.unsigned_minimum & fixed;
+        }
+
+        return bounds;
+    }
+
+    // Sums and products of signed values, unless they leave the range of the width
+    static std::optional<std::int64_t> add_signed(std::int64_t const value_1, std::int64_t const value_2, unsigned const width) noexcept
+    {
+        auto const maximum = static_cast<std::int64_t>(mask(width) >> 1U);
+        auto const minimum = -maximum - 1;
+        if ((value_2 > 0 && value_1 > maximum - value_2) || (value_2 < 0 && value_1 < minimum - value_2))
+            return std::nullopt;
+
+        return value_1 + value_2;
+    }
+    static std::optional<std::int64_t> multiply_signed(std::int64_t const value_1, std::int64_t const value_2, unsigned const width) noexcept
+    {
+        if (value_1 == 0 || value_2 == 0)
+            return 0;
+
+        auto const magnitude_1 = value_1 < 0 ? 0 - static_cast<std::uint64_t>(value_1) : static_cast<std::uint64_t>(value_1);
+        auto const magnitude_2 = value_2 < 0 ? 0 - static_cast<std::uint64_t>(value_2) : static_cast<std::uint64_t>(value_2);
+        auto const negative = (value_1 < 0) != (value_2 < 0);
+
+        // Negative results reach one further
+        if (magnitude_1 > ((mask(width) >> 1U) + (negative ? 1 : 0)) / magnitude_2)
+            return std::nullopt;
+
+        auto const magnitude = magnitude_1 * magnitude_2;
+
+        return negative ? static_cast<std::int64_t>(0 - magnitude) : static_cast<std::int64_t>(magnitude);
+    }
+    static std::optional<std::int64_t> divide_signed(std::int64_t const value_1, std::int64_t const value_2, unsigned const width) noexcept
+    {
+        // The lowest value divided by minus one is the only quotient to overflow
+        if (value_2 == -1 && value_1 == -static_cast<std::int64_t>(mask(width) >> 1U) - 1)
+            return std::nullopt;
+
+        return value_1 / value_2;
+    }
+
+    static expression_bounds add(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        auto const value_mask = mask(width);
+
+        auto result = top(width);
+
+        // Bits of the sums of the highest and the lowest possible operands, where the carries are known
+        auto const highest_sum = ~bounds_1.known_zeros + ~bounds_2.known_zeros;
+        auto const lowest_sum = bounds_1.known_ones + bounds_2.known_ones;
+        auto const carries_known = ~(highest_sum ^ bounds_1.known_zeros ^ bounds_2.known_zeros) | (lowest_sum ^ bounds_1.known_ones ^ bounds_2.known_ones);
+        auto const known = (bounds_1.known_zeros | bounds_1.known_ones) & (bounds_2.known_zeros | bounds_2.known_ones) & carries_known & value_mask;
+        result.known_zeros = ~highest_sum & known;
+        result.known_ones = lowest_sum & known;
+
+        // Fine as long as either all or none of the sums wrap around
+        auto const carry = [width](std::uint64_t const addend, std::uint64_t const sum)
+        {
+            return width == max_width ? sum < addend : (sum >> width) != 0;
+        };
+        auto const minimum = bounds_1.unsigned_minimum + bounds_2.unsigned_minimum;
+        auto const maximum = bounds_1.unsigned_maximum + bounds_2.unsigned_maximum;
+        if (carry(bounds_1.unsigned_minimum, minimum) == carry(bounds_1.unsigned_maximum, maximum))
+        {
+            result.unsigned_minimum = minimum & value_mask;
+            result.unsigned_maximum = maximum & value_mask;
+        }
+
+        auto const signed_minimum = add_signed(bounds_1.signed_minimum, bounds_2.signed_minimum, width);
+        auto const signed_maximum = add_signed(bounds_1.signed_maximum, bounds_2.signed_maximum, width);
+        if (signed_minimum.has_value() && signed_maximum.has_value())
+        {
+            result.signed_minimum = *signed_minimum;
+            result.signed_maximum = *signed_maximum;
+        }
+
+        return result;
+    }
+    static expression_bounds multiply(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        auto const value_mask = mask(width);
+
+        auto result = top(width);
+
+        // Low bits of the product depend on the equally many low bits of the operands only
+        auto const known_low = std::min(
+            static_cast<unsigned>(std::countr_one(bounds_1.known_zeros | bounds_1.known_ones)),
+            static_cast<unsigned>(std::countr_one(bounds_2.known_zeros | bounds_2.known_ones)));
+        auto const low_mask = mask(std::min(known_low, width));
+        auto const low_product = bounds_1.known_ones * bounds_2.known_ones;
+        result.known_zeros = ~low_product & low_mask;
+        result.known_ones = low_product & low_mask;
+
+        // Trailing zeros add up
+        auto const trailing_zeros = std::min(
+            static_cast<unsigned>(std::countr_one(bounds_1.known_zeros)) + static_cast<unsigned>(std::countr_one(bounds_2.known_zeros)),
+            width);
+        result.known_zeros |= mask(trailing_zeros);
+
+        if (bounds_2.unsigned_maximum == 0 || bounds_1.unsigned_maximum <= value_mask / bounds_2.unsigned_maximum)
+        {
+            result.unsigned_minimum = bounds_1.unsigned_minimum * bounds_2.unsigned_minimum;
+            result.unsigned_maximum = bounds_1.unsigned_maximum * bounds_2.unsigned_maximum;
+        }
+
+        std::array const products
+        {
+            multiply_signed(bounds_1.signed_minimum, bounds_2.signed_minimum, width),
+            multiply_signed(bounds_1.signed_minimum, bounds_2.signed_maximum, width),
+            multiply_signed(bounds_1.signed_maximum, bounds_2.signed_minimum, width),
+            multiply_signed(bounds_1.signed_maximum, bounds_2.signed_maximum, width)
+        };
+        if (std::all_of(products.begin(), products.end(), [](auto const& product) { return product.has_value(); }))
+        {
+            auto const [minimum, maximum] = std::minmax({*products[0], *products[1], *products[2], *products[3]});
+            result.signed_minimum = minimum;
+            result.signed_maximum = maximum;
+        }
+
+        return result;
+    }
+    static expression_bounds divide_unsigned(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        // Division by zero results in all ones
+        if (bounds_2.unsigned_maximum == 0)
+            return exact(mask(width), width);
+
+        auto result = top(width);
+        result.unsigned_minimum = bounds_1.unsigned_minimum / bounds_2.unsigned_maximum;
+        if (bounds_2.unsigned_minimum != 0)
+            result.unsigned_maximum = bounds_1.unsigned_maximum / bounds_2.unsigned_minimum;
+
+        return result;
+    }
+    static expression_bounds divide_signed(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        auto result = top(width);
+
+        // Division by zero depends on the sign of the dividend
+        if (bounds_2.signed_minimum <= 0 && bounds_2.signed_maximum >= 0)
+            return result;
+
+        // Quotients are monotonic in either operand as long as the divisor keeps its sign
+        std::array const quotients
+        {
+            divide_signed(bounds_1.signed_minimum, bounds_2.signed_minimum, width),
+            divide_signed(bounds_1.signed_minimum, bounds_2.signed_maximum, width),
+            divide_signed(bounds_1.signed_maximum, bounds_2.signed_minimum, width),
+            divide_signed(bounds_1.signed_maximum, bounds_2.signed_maximum, width)
+        };
+        if (std::all_of(quotients.begin(), quotients.end(), [](auto const& quotient) { return quotient.has_value(); }))
+        {
+            auto const [minimum, maximum] = std::minmax({*quotients[0], *quotients[1], *quotients[2], *quotients[3]});
+            result.signed_minimum = minimum;
+            result.signed_maximum = maximum;
+        }
+
+        return result;
+    }
+    static expression_bounds remainder_unsigned(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        // Also covers division by zero, which leaves the dividend
+        if (bounds_1.unsigned_maximum < bounds_2.unsigned_minimum)
+            return bounds_1;
+
+        auto result = top(width);
+        result.unsigned_maximum = bounds_1.unsigned_maximum;
+        if (bounds_2.unsigned_minimum != 0)
+            result.unsigned_maximum = std::min(result.unsigned_maximum, bounds_2.unsigned_maximum - 1);
+
+        return result;
+    }
+
+    static expression_bounds bitwise_and(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        auto result = top(width);
+        result.known_zeros = bounds_1.known_zeros | bounds_2.known_zeros;
+        result.known_ones = bounds_1.known_ones & bounds_2.known_ones;
+        result.unsigned_maximum = std::min(bounds_1.unsigned_maximum, bounds_2.unsigned_maximum);
+
+        return result;
+    }
+    static expression_bounds bitwise_or(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        auto result = top(width);
+        result.known_zeros = bounds_1.known_zeros & bounds_2.known_zeros;
+        result.known_ones = bounds_1.known_ones | bounds_2.known_ones;
+        result.unsigned_minimum = std::max(bounds_1.unsigned_minimum, bounds_2.unsigned_minimum);
+
+        return result;
+    }
+    static expression_bounds bitwise_xor(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width) noexcept
+    {
+        auto result = top(width);
+        result.known_zeros = (bounds_1.known_zeros & bounds_2.known_zeros) | (bounds_1.known_ones & bounds_2.known_ones);
+        result.known_ones = (bounds_1.known_zeros & bounds_2.known_ones) | (bounds_1.known_ones & bounds_2.known_zeros);
+
+        return result;
+    }
+    static expression_bounds bitwise_not(expression_bounds const& bounds, unsigned const width) noexcept
+    {
+        return
+        {
+            .known_zeros = bounds.known_ones,
+            .known_ones = bounds.known_zeros,
+            .unsigned_minimum = mask(width) - bounds.unsigned_maximum,
+            .unsigned_maximum = mask(width) - bounds.unsigned_minimum,
+            .signed_minimum = ~bounds.signed_maximum,
+            .signed_maximum = ~bounds.signed_minimum
+        };
+    }
+    static expression_bounds negate(expression_bounds const& bounds, unsigned const width) noexcept
+    {
+        return refine(add(bitwise_not(bounds, width), exact(1, width), width), width);
+    }
+
+    enum class shift_kind
+    {
+        left,
+        right_logical,
+        right_arithmetic
+    };
+
+    static expression_bounds shift(expression_bounds const& bounds, std::uint64_t const amount, shift_kind const kind, unsigned const width) noexcept
+    {
+        if (amount == 0)
+            return bounds;
+
+        auto const value_mask = mask(width);
+        auto const sign = std::uint64_t{1} << (width - 1);
+
+        auto result = top(width);
+        switch (kind)
+        {
+        case shift_kind::left:
+            if (amount >= width)
+                return exact(0, width);
+
+            result.known_zeros = ((bounds.known_zeros << amount) | mask(static_cast<unsigned>(amount))) & value_mask;
+            result.known_ones = (bounds.known_ones << amount) & value_mask;
+            // Unless bits are shifted out
+            if ((bounds.unsigned_maximum >> (width - amount)) == 0)
+            {
+                result.unsigned_minimum = bounds.unsigned_minimum << amount;
+                result.unsigned_maximum = bounds.unsigned_maximum << amount;
+            }
+            break;
+        case shift_kind::right_logical:
+            if (amount >= width)
+                return exact(0, width);
+
+            result.known_zeros = (bounds.known_zeros >> amount) | (~mask(width - static_cast<unsigned>(amount)) & value_mask);
+            result.known_ones = bounds.known_ones >> amount;
+            result.unsigned_minimum = bounds.unsigned_minimum >> amount;
+            result.unsigned_maximum = bounds.unsigned_maximum >> amount;
+            break;
+        case shift_kind::right_arithmetic:
+        {
+            // Shifting further only repeats the sign
+            auto const effective_amount = static_cast<unsigned>(std::min<std::uint64_t>(amount, width - 1));
+            auto const extension = ~mask(width - effective_amount) & value_mask;
+
+            result.known_zeros = (bounds.known_zeros >> effective_amount) | ((bounds.known_zeros & sign) != 0 ? extension : 0);
+            result.known_ones = (bounds.known_ones >> effective_amount) | ((bounds.known_ones & sign) != 0 ? extension : 0);
+            result.signed_minimum = bounds.signed_minimum >> effective_amount;
+            result.signed_maximum = bounds.signed_maximum >> effective_amount;
+            break;
+        }
+        }
+
+        return result;
+    }
+    static expression_bounds shift(expression_bounds const& bounds, expression_bounds const& amount, shift_kind const kind, unsigned const width) noexcept
+    {
+        // Join the results of all amounts the bounds admit, with all amounts beyond the width behaving the same
+        std::optional<expression_bounds> result;
+        auto const highest = std::min<std::uint64_t>(amount.unsigned_maximum, width);
+        for (auto current = amount.unsigned_minimum; current <= highest; ++current)
+        {
+            if (current < width && ((current & amount.known_zeros) != 0 || (current & amount.known_ones) != amount.known_ones))
+                continue;
+
+            auto const current_result = refine(shift(bounds, current, kind, width), width);
+            result = result.has_value() ? join(*result, current_result) : current_result;
+        }
+
+        return result.value_or(top(width));
+    }
+
+    static expression_bounds extract(expression_bounds const& bounds, unsigned const high, unsigned const low) noexcept
+    {
+        auto const width = high - low + 1;
+
+        auto result = top(width);
+        result.known_zeros = (bounds.known_zeros >> low) & mask(width);
+        result.known_ones = (bounds.known_ones >> low) & mask(width);
+        // Monotonic as long as the bits above do not change
+        if (high + 1 >= max_width || (bounds.unsigned_minimum >> (high + 1)) == (bounds.unsigned_maximum >> (high + 1)))
+        {
+            result.unsigned_minimum = (bounds.unsigned_minimum >> low) & mask(width);
+            result.unsigned_maximum = (bounds.unsigned_maximum >> low) & mask(width);
+        }
+
+        return result;
+    }
+    static expression_bounds concatenate(expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width_2) noexcept
+    {
+        auto result = top(max_width);
+        result.known_zeros = (bounds_1.known_zeros << width_2) | bounds_2.known_zeros;
+        result.known_ones = (bounds_1.known_ones << width_2) | bounds_2.known_ones;
+        result.unsigned_minimum = (bounds_1.unsigned_minimum << width_2) | bounds_2.unsigned_minimum;
+        result.unsigned_maximum = (bounds_1.unsigned_maximum << width_2) | bounds_2.unsigned_maximum;
+
+        return result;
+    }
+    static expression_bounds extend_zero(expression_bounds const& bounds, unsigned const width_1, unsigned const width) noexcept
+    {
+        auto result = top(width);
+        result.known_zeros = bounds.known_zeros | (~mask(width_1) & mask(width));
+        result.known_ones = bounds.known_ones;
+        result.unsigned_minimum = bounds.unsigned_minimum;
+        result.unsigned_maximum = bounds.unsigned_maximum;
+
+        return result;
+    }
+    static expression_bounds extend_sign(expression_bounds const& bounds, unsigned const width_1, unsigned const width) noexcept
+    {
+        auto const sign = std::uint64_t{1} << (width_1 - 1);
+        auto const extension = ~mask(width_1) & mask(width);
+
+        auto result = top(width);
+        result.known_zeros = bounds.known_zeros | ((bounds.known_zeros & sign) != 0 ? extension : 0);
+        result.known_ones = bounds.known_ones | ((bounds.known_ones & sign) != 0 ? extension : 0);
+        result.signed_minimum = bounds.signed_minimum;
+        result.signed_maximum = bounds.signed_maximum;
+
+        return result;
+    }
+
+    // Truth value of a comparison over the given ranges
+    template <typename Value>
+    static std::optional<bool> compare(Value const minimum_1, Value const maximum_1, Value const minimum_2, Value const maximum_2, bool const strict) noexcept
+    {
+        if (strict ? maximum_1 < minimum_2 : maximum_1 <= minimum_2)
+            return true;
+        if (strict ? minimum_1 >= maximum_2 : minimum_1 > maximum_2)
+            return false;
+
+        return std::nullopt;
+    }
+    static std::optional<bool> compare_equal(expression_bounds const& bounds_1, expression_bounds const& bounds_2) noexcept
+    {
+        if (bounds_1.unsigned_minimum == bounds_1.unsigned_maximum && bounds_2.unsigned_minimum == bounds_2.unsigned_maximum)
+            return bounds_1.unsigned_minimum == bounds_2.unsigned_minimum;
+
+        // Contradicting bits or disjoint ranges
+        if (((bounds_1.known_zeros & bounds_2.known_ones) | (bounds_1.known_ones & bounds_2.known_zeros)) != 0 ||
+            bounds_1.unsigned_maximum < bounds_2.unsigned_minimum || bounds_2.unsigned_maximum < bounds_1.unsigned_minimum ||
+            bounds_1.signed_maximum < bounds_2.signed_minimum || bounds_2.signed_maximum < bounds_1.signed_minimum)
+        {
+            return false;
+        }
+
+        return std::nullopt;
+    }
+
+    struct expression_analysis::state
+    {
+        z3_context const* context{};
+
+        // Facts by the identifiers of their terms, which are kept alive to retain their identifiers
+        std::unordered_map<unsigned, std::pair<z3_ast, expression_bounds>> bounds;
+        std::unordered_map<unsigned, std::pair<z3_ast, std::optional<bool>>> decisions;
+
+        void bind(z3_context const&);
+
+        [[nodiscard]] expression_bounds analyze(z3_ast const& term);
+        [[nodiscard]] std::optional<bool> decide(z3_ast const& term);
+
+    private:
+        // Bounds (or truth value, if decisive) of a term
+        struct fact
+        {
+            z3_ast term;
+            bool decisive;
+        };
+
+        [[nodiscard]] unsigned width(z3_ast const& term) const noexcept;
+
+        void derive(fact const& root);
+        [[nodiscard]] std::vector<fact> premises(fact const& conclusion) const;
+
+        // Known facts about the premises of a term
+        [[nodiscard]] expression_bounds const& known_bounds(z3_ast const& term) const;
+        [[nodiscard]] std::optional<bool> known_decision(z3_ast const& term) const;
+
+        [[nodiscard]] expression_bounds transfer(z3_ast const& term, unsigned width) const;
+        [[nodiscard]] std::optional<bool> evaluate(z3_ast const& term) const;
+    };
+
+    void expression_analysis::state::bind(z3_context const& value_context)
+    {
+        if (context == nullptr)
+            context = &value_context;
+        else if (context != &value_context)
+            throw std::logic_error("Invalid context");
+    }
+
+    unsigned expression_analysis::state::width(z3_ast const& term) const noexcept
+    {
+        z3_sort const sort(*context, Z3_get_sort, term);
+        if (sort.apply(Z3_get_sort_kind) != Z3_BV_SORT)
+            return 0;
+
+        return sort.apply(Z3_get_bv_sort_size);
+    }
+
+    // Operations the bounds of bit-vectors are derived for; others (e.g. symbols and memory reads) are unbounded
+    static bool transferable(Z3_decl_kind const kind) noexcept
+    {
+        switch (kind)
+        {
+        case Z3_OP_BADD:
+        case Z3_OP_BSUB:
+        case Z3_OP_BMUL:
+        case Z3_OP_BNEG:
+        case Z3_OP_BUDIV:
+        case Z3_OP_BUDIV_I:
+        case Z3_OP_BSDIV:
+        case Z3_OP_BSDIV_I:
+        case Z3_OP_BUREM:
+        case Z3_OP_BUREM_I:
+        case Z3_OP_BAND:
+        case Z3_OP_BOR:
+        case Z3_OP_BXOR:
+        case Z3_OP_BNOT:
+        case Z3_OP_BSHL:
+        case Z3_OP_BLSHR:
+        case Z3_OP_BASHR:
+        case Z3_OP_EXTRACT:
+        case Z3_OP_CONCAT:
+        case Z3_OP_ZERO_EXT:
+        case Z3_OP_SIGN_EXT:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    expression_bounds expression_analysis::state::analyze(z3_ast const& term)
+    {
+        derive({term, false});
+
+        return known_bounds(term);
+    }
+    std::optional<bool> expression_analysis::state::decide(z3_ast const& term)
+    {
+        derive({term, true});
+
+        return known_decision(term);
+    }
+
+    void expression_analysis::state::derive(fact const& root)
+    {
+        // Premises before their conclusions, on a stack of its own to cope with deep terms
+        std::vector<std::pair<fact, bool>> pending;
+        pending.emplace_back(root, false);
+        while (!pending.empty())
+        {
+            auto const [term, decisive] = pending.back().first;
+            auto const id = term.apply(Z3_get_ast_id);
+            if (decisive ? decisions.contains(id) : bounds.contains(id))
+            {
+                pending.pop_back();
+                continue;
+            }
+
+            // Revisited once all premises are known
+            if (!pending.back().second)
+            {
+                pending.back().second = true;
+
+                for (auto& premise : premises({term, decisive}))
+                    pending.emplace_back(std::move(premise), false);
+
+                continue;
+            }
+
+            if (decisive)
+            {
+                decisions.emplace(id, std::pair(term, evaluate(term)));
+            }
+            else
+            {
+                auto const term_width = width(term);
+                bounds.emplace(id, std::pair(term, refine(transfer(term, term_width), term_width)));
+            }
+
+            pending.pop_back();
+        }
+    }
+    std::vector<expression_analysis::state::fact> expression_analysis::state::premises(fact const& conclusion) const
+    {
+        std::vector<fact> result;
+
+        if (conclusion.term.apply(Z3_get_ast_kind) != Z3_APP_AST)
+            return result;
+
+        z3_app const application(*context, Z3_to_app, conclusion.term);
+
+        auto const argument_count = application.apply(Z3_get_app_num_args);
+        auto const argument = [this, &application](unsigned const argument_index)
+        {
+            return z3_ast(*context, Z3_get_app_arg, application, argument_index);
+        };
+
+        // Bit-vector operands within scope, as far as these are taken into account
+        auto const bounded = [this, &result](z3_ast operand)
+        {
+            auto const operand_width = width(operand);
+            if (operand_width == 0 || operand_width > max_width)
+                return false;
+
+            result.push_back({std::move(operand), false});
+            return true;
+        };
+
+        auto const kind = z3_func_decl(*context, Z3_get_app_decl, application).apply(Z3_get_decl_kind);
+        if (!conclusion.decisive)
+        {
+            if (kind == Z3_OP_ITE)
+            {
+                result.push_back({argument(0), true});
+                result.push_back({argument(1), false});
+                result.push_back({argument(2), false});
+            }
+            else if (transferable(kind))
+            {
+                for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+                {
+                    // Operations are unbounded once an operand is out of scope
+                    if (!bounded(argument(argument_index)))
+                        break;
+                }
+            }
+
+            return result;
+        }
+
+        switch (kind)
+        {
+        case Z3_OP_NOT:
+        case Z3_OP_AND:
+        case Z3_OP_OR:
+        case Z3_OP_IMPLIES:
+        case Z3_OP_XOR:
+        case Z3_OP_ITE:
+            for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+                result.push_back({argument(argument_index), true});
+            break;
+
+        case Z3_OP_EQ:
+        case Z3_OP_DISTINCT:
+            if (argument_count != 2)
+                break;
+
+            if (width(argument(0)) == 0)
+            {
+                result.push_back({argument(0), true});
+                result.push_back({argument(1), true});
+                break;
+            }
+            [[fallthrough]];
+        case Z3_OP_ULEQ:
+        case Z3_OP_UGEQ:
+        case Z3_OP_ULT:
+        case Z3_OP_UGT:
+        case Z3_OP_SLEQ:
+        case Z3_OP_SGEQ:
+        case Z3_OP_SLT:
+        case Z3_OP_SGT:
+            if (bounded(argument(0)))
+                result.push_back({argument(1), false});
+            break;
+
+        default:
+            break;
+        }
+
+        return result;
+    }
+
+    expression_bounds const& expression_analysis::state::known_bounds(z3_ast const& term) const
+    {
+        return bounds.at(term.apply(Z3_get_ast_id)).second;
+    }
+    std::optional<bool> expression_analysis::state::known_decision(z3_ast const& term) const
+    {
+        return decisions.at(term.apply(Z3_get_ast_id)).second;
+    }
+
+    expression_bounds expression_analysis::state::transfer(z3_ast const& term, unsigned const term_width) const
+    {
+        switch (term.apply(Z3_get_ast_kind))
+        {
+        case Z3_NUMERAL_AST:
+            if (std::uint64_t value{}; term.apply(Z3_get_numeral_uint64, &value))
+                return exact(value, term_width);
+
+            return top(term_width);
+        case Z3_APP_AST:
+            break;
+
+        default:
+            return top(term_width);
+        }
+
+        z3_app const application(*context, Z3_to_app, term);
+        z3_func_decl const declaration(*context, Z3_get_app_decl, application);
+
+        auto const argument_count = application.apply(Z3_get_app_num_args);
+        auto const argument = [this, &application](unsigned const argument_index)
+        {
+            return z3_ast(*context, Z3_get_app_arg, application, argument_index);
+        };
+
+        auto const kind = declaration.apply(Z3_get_decl_kind);
+        if (kind == Z3_OP_ITE)
+        {
+            if (auto const condition = known_decision(argument(0)); condition.has_value())
+                return known_bounds(argument(*condition ? 1 : 2));
+
+            return join(known_bounds(argument(1)), known_bounds(argument(2)));
+        }
+
+        if (!transferable(kind))
+            return top(term_width);
+
+        std::vector<expression_bounds> operands;
+        std::vector<unsigned> operand_widths;
+        operands.reserve(argument_count);
+        operand_widths.reserve(argument_count);
+        for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+        {
+            auto const current_argument = argument(argument_index);
+
+            // Wider terms are out of scope
+            auto const current_width = width(current_argument);
+            if (current_width == 0 || current_width > max_width)
+                return top(term_width);
+
+            operands.push_back(known_bounds(current_argument));
+            operand_widths.push_back(current_width);
+        }
+        if (operands.empty())
+            return top(term_width);
+
+        auto const fold = [&operands, term_width](expression_bounds (*const operation)(expression_bounds const&, expression_bounds const&, unsigned))
+        {
+            auto result = operands.front();
+            for (std::size_t operand_index = 1; operand_index < operands.size(); ++operand_index)
+                result = refine(operation(result, operands[operand_index], term_width), term_width);
+
+            return result;
+        };
+
+        switch (kind)
+        {
+        case Z3_OP_BADD:
+            return fold(add);
+        case Z3_OP_BSUB:
+            return fold(
+                [](expression_bounds const& bounds_1, expression_bounds const& bounds_2, unsigned const width)
+                {
+                    return add(bounds_1, negate(bounds_2, width), width);
+                });
+        case Z3_OP_BMUL:
+            return fold(multiply);
+        case Z3_OP_BNEG:
+            return negate(operands.front(), term_width);
+        case Z3_OP_BUDIV:
+        case Z3_OP_BUDIV_I:
+            return fold(divide_unsigned);
+        case Z3_OP_BSDIV:
+        case Z3_OP_BSDIV_I:
+            return fold(divide_signed);
+        case Z3_OP_BUREM:
+        case Z3_OP_BUREM_I:
+            return fold(remainder_unsigned);
+        case Z3_OP_BAND:
+            return fold(bitwise_and);
+        case Z3_OP_BOR:
+            return fold(bitwise_or);
+        case Z3_OP_BXOR:
+            return fold(bitwise_xor);
+        case Z3_OP_BNOT:
+            return bitwise_not(operands.front(), term_width);
+        case Z3_OP_BSHL:
+            return shift(operands.front(), operands.back(), shift_kind::left, term_width);
+        case Z3_OP_BLSHR:
+            return shift(operands.front(), operands.back(), shift_kind::right_logical, term_width);
+        case Z3_OP_BASHR:
+            return shift(operands.front(), operands.back(), shift_kind::right_arithmetic, term_width);
+        case Z3_OP_EXTRACT:
+            return extract(
+                operands.front(),
+                static_cast<unsigned>(declaration.apply(Z3_get_decl_int_parameter, 0U)),
+                static_cast<unsigned>(declaration.apply(Z3_get_decl_int_parameter, 1U)));
+        case Z3_OP_CONCAT:
+        {
+            if (term_width > max_width)
+                return top(max_width);
+
+            auto result = operands.front();
+            for (std::size_t operand_index = 1; operand_index < operands.size(); ++operand_index)
+                result = concatenate(result, operands[operand_index], operand_widths[operand_index]);
+
+            return result;
+        }
+        case Z3_OP_ZERO_EXT:
+            return extend_zero(operands.front(), operand_widths.front(), term_width);
+        case Z3_OP_SIGN_EXT:
+            return extend_sign(operands.front(), operand_widths.front(), term_width);
+
+        default:
+            return top(term_width);
+        }
+    }
+
+    std::optional<bool> expression_analysis::state::evaluate(z3_ast const& term) const
+    {
+        if (term.apply(Z3_get_ast_kind) != Z3_APP_AST)
+            return std::nullopt;
+
+        z3_app const application(*context, Z3_to_app, term);
+
+        auto const argument_count = application.apply(Z3_get_app_num_args);
+        auto const argument = [this, &application](unsigned const argument_index)
+        {
+            return z3_ast(*context, Z3_get_app_arg, application, argument_index);
+        };
+
+        // Comparisons of bit-vectors within scope
+        auto const compare_operands = [this, &argument](auto const& comparison) -> std::optional<bool>
+        {
+            auto const operand_1 = argument(0);
+            auto const operand_2 = argument(1);
+
+            auto const operand_width = width(operand_1);
+            if (operand_width == 0 || operand_width > max_width)
+                return std::nullopt;
+
+            return comparison(known_bounds(operand_1), known_bounds(operand_2));
+        };
+        auto const compare_unsigned = [&compare_operands](bool const swapped, bool const strict)
+        {
+            return compare_operands(
+                [swapped, strict](expression_bounds const& bounds_1, expression_bounds const& bounds_2)
+                {
+                    auto const& left = swapped ? bounds_2 : bounds_1;
+                    auto const& right = swapped ? bounds_1 : bounds_2;
+                    return compare(left.unsigned_minimum, left.unsigned_maximum, right.unsigned_minimum, right.unsigned_maximum, strict);
+                });
+        };
+        auto const compare_signed = [&compare_operands](bool const swapped, bool const strict)
+        {
+            return compare_operands(
+                [swapped, strict](expression_bounds const& bounds_1, expression_bounds const& bounds_2)
+                {
+                    auto const& left = swapped ? bounds_2 : bounds_1;
+                    auto const& right = swapped ? bounds_1 : bounds_2;
+                    return compare(left.signed_minimum, left.signed_maximum, right.signed_minimum, right.signed_maximum, strict);
+                });
+        };
+
+        auto const kind = z3_func_decl(*context, Z3_get_app_decl, application).apply(Z3_get_decl_kind);
+        switch (kind)
+        {
+        case Z3_OP_TRUE:
+            return true;
+        case Z3_OP_FALSE:
+            return false;
+
+        case Z3_OP_NOT:
+            if (auto const operand = known_decision(argument(0)); operand.has_value())
+                return !*operand;
+
+            return std::nullopt;
+        case Z3_OP_AND:
+        case Z3_OP_OR:
+        {
+            // Decided by a single operand of the absorbing value, otherwise by all operands
+            auto const absorbing = kind == Z3_OP_OR;
+            auto decided = true;
+            for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+            {
+                auto const operand = known_decision(argument(argument_index));
+                if (operand == absorbing)
+                    return absorbing;
+
+                decided &= operand.has_value();
+            }
+            if (decided)
+                return !absorbing;
+
+            return std::nullopt;
+        }
+        case Z3_OP_IMPLIES:
+        {
+            auto const premise = known_decision(argument(0));
+            if (premise == false)
+                return true;
+
+            auto const conclusion = known_decision(argument(1));
+            if (conclusion == true)
+                return true;
+            if (premise == true && conclusion == false)
+                return false;
+
+            return std::nullopt;
+        }
+        case Z3_OP_XOR:
+        {
+            auto const operand_1 = known_decision(argument(0));
+            auto const operand_2 = known_decision(argument(1));
+            if (operand_1.has_value() && operand_2.has_value())
+                return *operand_1 != *operand_2;
+
+            return std::nullopt;
+        }
+        case Z3_OP_ITE:
+        {
+            auto const condition = known_decision(argument(0));
+            if (condition.has_value())
+                return known_decision(argument(*condition ? 1 : 2));
+
+            auto const branch_1 = known_decision(argument(1));
+            if (branch_1.has_value() && branch_1 == known_decision(argument(2)))
+                return branch_1;
+
+            return std::nullopt;
+        }
+
+        case Z3_OP_EQ:
+        case Z3_OP_DISTINCT:
+        {
+            if (argument_count != 2)
+                return std::nullopt;
+
+            auto const distinct = kind == Z3_OP_DISTINCT;
+
+            std::optional<bool> equal;
+            if (width(argument(0)) == 0)
+            {
+                auto const operand_1 = known_decision(argument(0));
+                auto const operand_2 = known_decision(argument(1));
+                if (operand_1.has_value() && operand_2.has_value())
+                    equal = *operand_1 == *operand_2;
+            }
+            else
+            {
+                equal = compare_operands(compare_equal);
+            }
+
+            if (equal.has_value())
+                return *equal != distinct;
+
+            return std::nullopt;
+        }
+
+        case Z3_OP_ULEQ:
+            return compare_unsigned(false, false);
+        case Z3_OP_UGEQ:
+            return compare_unsigned(true, false);
+        case Z3_OP_ULT:
+            return compare_unsigned(false, true);
+        case Z3_OP_UGT:
+            return compare_unsigned(true, true);
+        case Z3_OP_SLEQ:
+            return compare_signed(false, false);
+        case Z3_OP_SGEQ:
+            return compare_signed(true, false);
+        case Z3_OP_SLT:
+            return compare_signed(false, true);
+        case Z3_OP_SGT:
+            return compare_signed(true, true);
+
+        default:
+            return std::nullopt;
+        }
+    }
+
+    expression_analysis::expression_analysis() :
+        base_(std::make_unique<state>())
+    { }
+
+    expression_analysis::~expression_analysis() noexcept = default;
+
+    expression_analysis::expression_analysis(expression_analysis const& other) :
+        base_(std::make_unique<state>(*other.base_))
+    { }
+    expression_analysis& expression_analysis::operator=(expression_analysis const& other)
+    {
+        if (&other != this)
+            base_ = std::make_unique<state>(*other.base_);
+
+        return *this;
+    }
+
+    expression_analysis::expression_analysis(expression_analysis&&) noexcept = default;
+    expression_analysis& expression_analysis::operator=(expression_analysis&&) noexcept = default;
+
+    template <integral_expression_typename T>
+    expression_bounds expression_analysis::bounds(expression<T> const& value)
+    {
+        static constexpr unsigned width = sizeof(T) * CHAR_BIT;
+
+        value.observe();
+
+        if (value.concrete_)
+            return exact(value.value_, width);
+
+        base_->bind(value.base_.context());
+
+        return base_->analyze(value.base_);
+    }
+
+    std::optional<bool> expression_analysis::decide(expression<bool> const& value)
+    {
+        value.observe();
+
+        if (value.concrete_)
+            return value.value_ != 0;
+
+        base_->bind(value.base_.context());
+
+        return base_->decide(value.base_);
+    }
+
+    std::size_t expression_analysis::size() const noexcept
+    {
+        return base_->bounds.size() + base_->decisions.size();
+    }
+}
+
+// NOLINTNEXTLINE [cppcoreguidelines-macro-usage]
+#define EXPRESSION(T) expression<TYPE(T)>
+
+// NOLINTNEXTLINE [cppcoreguidelines-macro-usage]
+#define INSTANTIATE_BOUNDS(T) \
+    template fml::expression_bounds fml::expression_analysis::bounds(EXPRESSION(T) const&);
+LOOP_TYPES_0(INSTANTIATE_BOUNDS);
@@ -0,0 +1,59 @@
+#include <atomic>
+
+#include <formulae1/expression_context.hpp>
+
+#include "z3_context.hpp"
+
+namespace fml
+{
+    // NOLINTNEXTLINE [cppcoreguidelines-avoid-non-const-global-variables]
+    static std::atomic<context_mode> current_context_mode(context_mode::shared);
+
+    void select_context_mode(context_mode const mode) noexcept
+    {
+        current_context_mode.store(mode);
+    }
+    context_mode selected_context_mode() noexcept
+    {
+        return current_context_mode.load();
+    }
+
+    expression_context::expression_context() noexcept :
+        base_(std::make_unique<z3_context>())
+    { }
+
+    expression_context::~expression_context() noexcept = default;
+
+    expression_context::expression_context(expression_context&&) noexcept = default;
+    expression_context& expression_context::operator=(expression_context&&) noexcept = default;
+
+    void expression_context::select_simplification_mode(simplification_mode const mode) noexcept
+    {
+        base_->select_simplification_mode(mode);
+    }
+    simplification_mode expression_context::selected_simplification_mode() const noexcept
+    {
+        return base_->selected_simplification_mode();
+    }
+
+    void expression_context::select_dependency_cache_capacity(std::size_t const capacity) noexcept
+    {
+        base_->select_dependency_cache_capacity(capacity);
+    }
+    std::size_t expression_context::selected_dependency_cache_capacity() const noexcept
+    {
+        return base_->selected_dependency_cache_capacity();
+    }
+
+    expression_context& expression_context::current() noexcept
+    {
+        static expression_context shared_context;
+
+        if (current_context_mode.load() == context_mode::shared)
+            return shared_context;
+
+        thread_local expression_context thread_context;
+
+        return thread_context;
+    }
+}
@@ -30,11 +30,14 @@ namespace fml
     template <typename T>
     expression<T> expression_model::apply(expression<T> const& value) const
     {
+        if (&value.base_.context() != &base_->context())
+            throw std::logic_error("Invalid context");
+
         _Z3_ast* application_resource{};
-        if (!base_->apply(Z3_model_eval, *value.base_, false, &application_resource))
+        if (!base_->apply(Z3_model_eval, value.base(), false, &application_resource))
             throw std::logic_error("Invalid expression");
 
-        return expression<T>(z3_ast(application_resource));
+        return expression<T>(z3_ast(base_->context(), application_resource));
     }
 
     std::ostream& operator<<(std::ostream& stream, expression_model const& model) noexcept
@@ -1,22 +1,421 @@
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+#include <formulae1/expression_analysis.hpp>
 #include <formulae1/expression_solver.hpp>
 
+#include "preprocessor_types.hpp"
 #include "z3_resource.ipp"
+#include "z3_symbol_table.hpp"
 
 namespace fml
 {
+    struct check_task::state
+    {
+        // Declared first to be destroyed last
+        z3_context context;
+
+        z3_context const* origin;
+
+        z3_solver solver;
+        std::vector<z3_ast> assumptions;
+
+        bool model_generation{};
+
+        std::atomic<bool> cancelled{false};
+        std::future<Z3_lbool> outcome;
+
+        state(z3_context const& origin_context, std::vector<z3_ast> const& origin_assertions) noexcept :
+            origin(&origin_context),
+            solver(context, Z3_mk_simple_solver)
+        {
+            // Z3 declines to translate solvers within scopes
+            for (auto const& assertion : origin_assertions)
+                solver.apply(Z3_solver_assert, z3_ast(context, Z3_translate(origin_context, assertion, context)));
+        }
+    };
+
+    check_task::check_task(std::unique_ptr<state> base) noexcept :
+        state_(std::move(base))
+    { }
+
+    check_task::~check_task() noexcept
+    {
+        cancel();
+    }
+
+    check_task::check_task(check_task&&) noexcept = default;
+    check_task& check_task::operator=(check_task&& other) noexcept
+    {
+        if (&other != this)
+        {
+            cancel();
+
+            state_ = std::move(other.state_);
+        }
+
+        return *this;
+    }
+
+    bool check_task::ready() const noexcept
+    {
+        return state_ == nullptr || !state_->outcome.valid() || state_->outcome.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+    }
+
+    check_result check_task::get()
+    {
+        if (state_ == nullptr || !state_->outcome.valid())
+            throw std::logic_error("Invalid task");
+
+        switch (state_->outcome.get())
+        {
+        case Z3_L_FALSE:
+            return {satisfiability::unsatisfiable, std::nullopt};
+        case Z3_L_TRUE:
+        {
+            if (!state_->model_generation)
+                return {satisfiability::satisfiable, std::nullopt};
+
+            z3_model const model(state_->context, state_->solver.apply(Z3_solver_get_model));
+
+            return
+            {
+                satisfiability::satisfiable,
+                expression_model(
+                    z3_model(
+                        *state_->origin,
+                        [this, &model](_Z3_context* const target)
+                        {
+                            return Z3_model_translate(state_->context, model, target);
+                        }))
+            };
+        }
+
+        default:
+            return {};
+        }
+    }
+
+    void check_task::cancel() noexcept
+    {
+        if (state_ == nullptr || !state_->outcome.valid())
+            return;
+
+        state_->cancelled = true;
+
+        // Repeat in case the check has not quite started yet
+        while (state_->outcome.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+            Z3_interrupt(state_->context);
+    }
+
     expression_solver::expression_solver() noexcept :
-        base_(std::make_unique<z3_solver>(Z3_mk_simple_solver))
+        expression_solver(expression_context::current())
+    { }
+    expression_solver::expression_solver(expression_context const& context) noexcept :
+        base_(std::make_unique<z3_solver>(z3_context::instance(context), Z3_mk_simple_solver))
     { }
 
     expression_solver::~expression_solver() noexcept = default;
 
+    using z3_app = z3_resource<_Z3_app>;
+    using z3_func_decl = z3_resource<_Z3_func_decl, _Z3_ast, Z3_inc_ref, Z3_dec_ref>;
+    using z3_params = z3_resource<_Z3_params, _Z3_params, Z3_params_inc_ref, Z3_params_dec_ref>;
+    using z3_sort = z3_resource<_Z3_sort, _Z3_ast, Z3_inc_ref, Z3_dec_ref>;
+    using z3_symbol = z3_resource<_Z3_symbol>;
+    using z3_tactic = z3_resource<_Z3_tactic, _Z3_tactic, Z3_tactic_inc_ref, Z3_tactic_dec_ref>;
+
+    static std::unique_ptr<z3_solver> duplicate(z3_context const& context, std::vector<z3_ast> const& assertions) noexcept
+    {
+        // Prevent copies from sharing assertions (Z3 declines to translate solvers within scopes)
+        auto result = std::make_unique<z3_solver>(context, Z3_mk_simple_solver);
+        for (auto const& assertion : assertions)
+            result->apply(Z3_solver_assert, assertion);
+
+        return result;
+    }
+
+    static void configure(z3_solver const& solver, solver_limits const& limits, bool const model_generation) noexcept
+    {
+        auto const& context = solver.context();
+
+        // Z3 takes the largest timeout as unbounded
+        auto timeout = std::numeric_limits<unsigned>::max();
+        if (limits.timeout.count() > 0 && limits.timeout.count() < timeout)
+            timeout = static_cast<unsigned>(limits.timeout.count());
+
+        // All are always set, as Z3 keeps parameters across calls
+        z3_params const parameters(context, Z3_mk_params);
+        parameters.apply(Z3_params_set_uint, z3_symbol(context, Z3_mk_string_symbol, "timeout"), timeout);
+        parameters.apply(Z3_params_set_uint, z3_symbol(context, Z3_mk_string_symbol, "rlimit"), limits.resource_limit);
+        parameters.apply(Z3_params_set_bool, z3_symbol(context, Z3_mk_string_symbol, "model"), model_generation);
+
+        solver.apply(Z3_solver_set_params, parameters);
+    }
+
+    // Copy of the assertions within a private context, to be checked by another thread
+    struct replica
+    {
+        // Declared first to be destroyed last
+        z3_context context;
+
+        std::unique_ptr<z3_solver> solver;
+
+        Z3_lbool outcome{Z3_L_UNDEF};
+        bool finished{};
+    };
+
+    static std::unique_ptr<replica> replicate(z3_context const& origin, std::vector<_Z3_ast*> const& formulas, solver_configuration const& configuration, solver_limits const& limits, bool const model_generation)
+    {
+        auto result = std::make_unique<replica>();
+        auto const& context = result->context;
+
+        switch (configuration.strategy)
+        {
+        case solver_strategy::general:
+            result->solver = std::make_unique<z3_solver>(context, Z3_mk_solver);
+            break;
+        case solver_strategy::bit_blast:
+            result->solver = std::make_unique<z3_solver>(context, Z3_mk_solver_from_tactic, z3_tactic(context, Z3_mk_tactic, "qfbv"));
+            break;
+
+        default:
+            result->solver = std::make_unique<z3_solver>(context, Z3_mk_simple_solver);
+            break;
+        }
+
+        configure(*result->solver, limits, model_generation);
+        if (configuration.random_seed != 0)
+        {
+            z3_params const parameters(context, Z3_mk_params);
+            parameters.apply(Z3_params_set_uint, z3_symbol(context, Z3_mk_string_symbol, "random_seed"), configuration.random_seed);
+            result->solver->apply(Z3_solver_set_params, parameters);
+        }
+
+        for (auto* const formula : formulas)
+            result->solver->apply(Z3_solver_assert, z3_ast(context, Z3_translate(origin, formula, context)));
+
+        return result;
+    }
+
+    static bool finished(std::vector<std::unique_ptr<replica>> const& replicas) noexcept
+    {
+        return std::all_of(replicas.begin(), replicas.end(), [](auto const& current) { return current->finished; });
+    }
+    // Interrupts the replicas until all of them have finished
+    static void interrupt(std::vector<std::unique_ptr<replica>> const& replicas, std::unique_lock<std::mutex>& lock, std::condition_variable& finish)
+    {
+        // Repeat in case a check has not quite started yet
+        while (!finished(replicas))
+        {
+            for (auto const& current : replicas)
+            {
+                if (!current->finished)
+                    Z3_interrupt(current->context);
+            }
+
+            finish.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    // Model of the last check of a replica, moved to the original context
+    static z3_model translate_model(replica const& current, z3_context const& origin) noexcept
+    {
+        z3_model const model(current.context, current.solver->apply(Z3_solver_get_model));
+
+        return z3_model(
+            origin,
+            [&current, &model](_Z3_context* const target)
+            {
+                return Z3_model_translate(current.context, model, target);
+            });
+    }
+
+    // Bits to split the search space on, taken from the most significant ones of the most frequent symbols
+    static std::vector<z3_ast> split_literals(z3_context const& context, std::vector<_Z3_ast*> const& formulas, unsigned const depth)
+    {
+        // Bit-vector constants by their number of occurrences
+        std::unordered_map<unsigned, std::pair<z3_ast, std::size_t>> constants;
+
+        std::unordered_set<unsigned> visited;
+        std::vector<z3_ast> pending;
+        for (auto* const formula : formulas)
+            pending.emplace_back(context, formula);
+        while (!pending.empty())
+        {
+            auto const term = std::move(pending.back());
+            pending.pop_back();
+
+            if (term.apply(Z3_get_ast_kind) != Z3_APP_AST)
+                continue;
+
+            z3_app const application(context, Z3_to_app, term);
+            auto const argument_count = application.apply(Z3_get_app_num_args);
+            if (argument_count == 0)
+            {
+                if (z3_func_decl(context, Z3_get_app_decl, application).apply(Z3_get_decl_kind) == Z3_OP_UNINTERPRETED &&
+                    Z3_get_sort_kind(context, Z3_get_sort(context, term)) == Z3_BV_SORT)
+                {
+                    ++constants.try_emplace(term.apply(Z3_get_ast_id), term, 0).first->second.second;
+                }
+
+                continue;
+            }
+
+            if (!visited.insert(term.apply(Z3_get_ast_id)).second)
+                continue;
+
+            for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+                pending.emplace_back(context, Z3_get_app_arg, application, argument_index);
+        }
+
+        std::vector<std::pair<z3_ast, std::size_t>> ranking;
+        ranking.reserve(constants.size());
+        for (auto& [id, constant] : constants)
+            ranking.push_back(std::move(constant));
+        std::sort(ranking.begin(), ranking.end(),
+            [](auto const& constant_1, auto const& constant_2)
+            {
+                if (constant_1.second != constant_2.second)
+                    return constant_1.second > constant_2.second;
+
+                // Deterministic order among equally frequent ones
+                return constant_1.first.apply(Z3_get_ast_id) < constant_2.first.apply(Z3_get_ast_id);
+            });
+
+        // Round-robin over the symbols, from their most significant bit downwards
+        std::vector<z3_ast> literals;
+        for (unsigned bit_offset = 0; literals.size() < depth; ++bit_offset)
+        {
+            auto const size = literals.size();
+            for (auto const& [constant, occurrences] : ranking)
+            {
+                if (literals.size() == depth)
+                    break;
+
+                auto const width = Z3_get_bv_sort_size(context, Z3_get_sort(context, constant));
+                if (bit_offset >= width)
+                    continue;
+
+                auto const bit = width - 1 - bit_offset;
+                literals.emplace_back(context, Z3_mk_eq, z3_ast(context, Z3_mk_extract, bit, bit, constant), z3_ast(context, Z3_mk_int, 1, z3_sort(context, Z3_mk_bv_sort, 1U)));
+            }
+
+            // All bits used up
+            if (literals.size() == size)
+                break;
+        }
+
+        return literals;
+    }
+
+    static std::vector<z3_ast> conjuncts(z3_ast const& formula)
+    {
+        auto const& context = formula.context();
+
+        if (formula.apply(Z3_get_ast_kind) == Z3_APP_AST)
+        {
+            z3_app const application(context, Z3_to_app, formula);
+            if (z3_func_decl(context, Z3_get_app_decl, application).apply(Z3_get_decl_kind) == Z3_OP_AND)
+            {
+                auto const argument_count = application.apply(Z3_get_app_num_args);
+
+                std::vector<z3_ast> arguments;
+                arguments.reserve(argument_count);
+                for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+                    arguments.emplace_back(context, Z3_get_app_arg, application, argument_index);
+
+                return arguments;
+            }
+        }
+
+        return {formula};
+    }
+
+    static bool precedes(z3_ast const& constraint_1, z3_ast const& constraint_2) noexcept
+    {
+        return std::less<_Z3_ast*>{}(constraint_1, constraint_2);
+    }
+    static std::vector<z3_ast> ordered(std::vector<z3_ast> constraints)
+    {
+        std::sort(constraints.begin(), constraints.end(), precedes);
+        constraints.erase(
+            std::unique(constraints.begin(), constraints.end(),
+                [](z3_ast const& constraint_1, z3_ast const& constraint_2)
+                {
+                    return static_cast<_Z3_ast*>(constraint_1) == static_cast<_Z3_ast*>(constraint_2);
+                }),
+            constraints.end());
+
+        return constraints;
+    }
+
     expression_solver::expression_solver(expression_solver const& other) noexcept :
-        base_(std::make_unique<z3_solver>(*other.base_))
-    { }
+        limits_(other.limits_),
+        applied_limits_(other.applied_limits_),
+        model_generation_(other.model_generation_),
+        query_mode_(other.query_mode_),
+        assertions_(other.assertions_),
+        assertion_dependencies_(other.assertion_dependencies_),
+        assertion_indirect_(other.assertion_indirect_),
+        slicing_mode_(other.slicing_mode_),
+        portfolio_(other.portfolio_),
+        split_depth_(other.split_depth_),
+        cache_capacity_(other.cache_capacity_),
+        counterexample_capacity_(other.counterexample_capacity_)
+    {
+        base_ = duplicate(other.base_->context(), assertions_);
+        configure(*base_, applied_limits_, model_generation_);
+    }
     expression_solver& expression_solver::operator=(expression_solver const& other) noexcept
     {
         if (&other != this)
-            base_ = std::make_unique<z3_solver>(*other.base_);
+        {
+            base_ = duplicate(other.base_->context(), other.assertions_);
+            limits_ = other.limits_;
+            applied_limits_ = other.applied_limits_;
+            model_generation_ = other.model_generation_;
+            configure(*base_, applied_limits_, model_generation_);
+            query_mode_ = other.query_mode_;
+            prefix_.clear();
+
+            assertions_ = other.assertions_;
+            assertion_dependencies_ = other.assertion_dependencies_;
+            assertion_indirect_ = other.assertion_indirect_;
+            assertion_scopes_.clear();
+
+            slicing_mode_ = other.slicing_mode_;
+
+            portfolio_ = other.portfolio_;
+
+            split_depth_ = other.split_depth_;
+
+            cache_capacity_ = other.cache_capacity_;
+            clear_cache();
+            cache_hits_ = 0;
+            cache_misses_ = 0;
+
+            counterexample_capacity_ = other.counterexample_capacity_;
+            counterexamples_.clear();
+            unsatisfiable_sets_.clear();
+            counterexample_hits_ = 0;
+
+            // Bound to the former context
+            empty_model_.reset();
+            analysis_ = expression_analysis();
+            trivial_hits_ = 0;
+        }
 
         return *this;
     }
@@ -24,19 +423,1179 @@ namespace fml
     expression_solver::expression_solver(expression_solver&&) noexcept = default;
     expression_solver& expression_solver::operator=(expression_solver&&) noexcept = default;
 
-    std::optional<expression_model> expression_solver::check(expression<bool> const& value) const
+    void expression_solver::select_limits(solver_limits const limits) noexcept
+    {
+        limits_ = limits;
+    }
+    solver_limits expression_solver::selected_limits() const noexcept
+    {
+        return limits_;
+    }
+
+    void expression_solver::select_model_generation(bool const model_generation) noexcept
+    {
+        model_generation_ = model_generation;
+
+        configure(*base_, applied_limits_, model_generation_);
+    }
+    bool expression_solver::selected_model_generation() const noexcept
+    {
+        return model_generation_;
+    }
+
+    void expression_solver::select_query_mode(query_mode const mode) noexcept
+    {
+        release_prefix();
+
+        query_mode_ = mode;
+    }
+    query_mode expression_solver::selected_query_mode() const noexcept
+    {
+        return query_mode_;
+    }
+
+    void expression_solver::select_portfolio(std::vector<solver_configuration> portfolio)
+    {
+        portfolio_ = std::move(portfolio);
+    }
+    std::vector<solver_configuration> const& expression_solver::selected_portfolio() const noexcept
+    {
+        return portfolio_;
+    }
+
+    void expression_solver::select_split_depth(unsigned const depth) noexcept
+    {
+        // Keep the number of cubes countable
+        split_depth_ = std::min(depth, max_split_depth);
+    }
+    unsigned expression_solver::selected_split_depth() const noexcept
+    {
+        return split_depth_;
+    }
+
+    void expression_solver::select_slicing_mode(slicing_mode const mode) noexcept
+    {
+        slicing_mode_ = mode;
+    }
+    slicing_mode expression_solver::selected_slicing_mode() const noexcept
+    {
+        return slicing_mode_;
+    }
+
+    void expression_solver::select_cache_capacity(std::size_t const capacity) noexcept
     {
-        auto* const value_resource = static_cast<_Z3_ast*>(*value.base_);
+        cache_capacity_ = capacity;
 
-        switch (base_->apply(Z3_solver_check_assumptions, 1U, &value_resource))
+        // Evict the least recently used
+        while (cache_entries_.size() > cache_capacity_)
         {
-        case Z3_L_FALSE:
-            return std::nullopt;
-        case Z3_L_TRUE:
-            return expression_model(z3_model(base_->apply(Z3_solver_get_model)));
+            cache_index_.erase(cache_entries_.back().first);
+            cache_entries_.pop_back();
+        }
+    }
+    std::size_t expression_solver::selected_cache_capacity() const noexcept
+    {
+        return cache_capacity_;
+    }
 
-        default:
+    std::size_t expression_solver::cache_hits() const noexcept
+    {
+        return cache_hits_;
+    }
+    std::size_t expression_solver::cache_misses() const noexcept
+    {
+        return cache_misses_;
+    }
+
+    void expression_solver::select_counterexample_capacity(std::size_t const capacity) noexcept
+    {
+        counterexample_capacity_ = capacity;
+
+        while (counterexamples_.size() > counterexample_capacity_)
+            counterexamples_.pop_back();
+        while (unsatisfiable_sets_.size() > counterexample_capacity_)
+            unsatisfiable_sets_.pop_back();
+    }
+    std::size_t expression_solver::selected_counterexample_capacity() const noexcept
+    {
+        return counterexample_capacity_;
+    }
+
+    std::size_t expression_solver::counterexample_hits() const noexcept
+    {
+        return counterexample_hits_;
+    }
+
+    std::size_t expression_solver::trivial_hits() const noexcept
+    {
+        return trivial_hits_;
+    }
+    std::size_t expression_solver::analyzed_facts() const noexcept
+    {
+        return analysis_.size();
+    }
+
+    void expression_solver::add(expression<bool> const& value)
+    {
+        if (&value.base_.context() != &base_->context())
+            throw std::logic_error("Invalid context");
+
+        release_prefix();
+        clear_cache();
+
+        // Previous models need not satisfy the new assertion, whereas unsatisfiable sets remain unsatisfiable
+        counterexamples_.clear();
+
+        value.observe();
+
+        assertions_.push_back(value.base());
+
+        auto const dependencies = value.dependency_ids();
+        assertion_dependencies_.insert(assertion_dependencies_.end(), dependencies.begin(), dependencies.end());
+        if (!value.dependencies_indirect().empty())
+            assertion_indirect_ = true;
+
+        base_->apply(Z3_solver_assert, value.base());
+    }
+
+    void expression_solver::push() noexcept
+    {
+        release_prefix();
+
+        assertion_scopes_.push_back({assertions_.size(), assertion_dependencies_.size(), assertion_indirect_});
+
+        base_->apply(Z3_solver_push);
+    }
+    void expression_solver::pop(unsigned const count)
+    {
+        release_prefix();
+
+        if (count > base_->apply(Z3_solver_get_num_scopes))
+            throw std::logic_error("Invalid scope");
+        if (count == 0)
+            return;
+
+        clear_cache();
+
+        // Unsatisfiable sets may rely on the dropped assertions, whereas previous models still satisfy the rest
+        unsatisfiable_sets_.clear();
+
+        auto const scope = assertion_scopes_.end() - count;
+        assertions_.erase(assertions_.begin() + static_cast<std::ptrdiff_t>(scope->assertion_count), assertions_.end());
+        assertion_dependencies_.resize(scope->dependency_count);
+        assertion_indirect_ = scope->indirect;
+        assertion_scopes_.erase(scope, assertion_scopes_.end());
+
+        base_->apply(Z3_solver_pop, count);
+    }
+
+    static std::optional<expression_model> decided(check_result result)
+    {
+        if (result.status == satisfiability::unknown)
             throw std::logic_error("Invalid expression");
+        if (result.status == satisfiability::satisfiable && !result.model.has_value())
+            throw std::logic_error("Invalid model");
+
+        return std::move(result.model);
+    }
+
+    std::optional<expression_model> expression_solver::check() const
+    {
+        return decided(solve());
+    }
+    std::optional<expression_model> expression_solver::check(expression<bool> const& assumption) const
+    {
+        return decided(solve(assumption));
+    }
+    std::optional<expression_model> expression_solver::check(std::vector<expression<bool>> const& assumptions) const
+    {
+        return decided(solve(assumptions));
+    }
+
+    // Clears a model request flag for its lifetime, so that it is restored when checks throw
+    class model_suppression
+    {
+        bool& models_requested_;
+        bool previous_;
+
+    public:
+        explicit model_suppression(bool& models_requested) noexcept :
+            models_requested_(models_requested),
+            previous_(std::exchange(models_requested, false))
+        { }
+        ~model_suppression() noexcept
+        {
+            models_requested_ = previous_;
         }
+
+        model_suppression(model_suppression const&) = delete;
+        model_suppression& operator=(model_suppression const&) = delete;
+
+        model_suppression(model_suppression&&) = delete;
+        model_suppression& operator=(model_suppression&&) = delete;
+    };
+
+    satisfiability expression_solver::check_satisfiability() const
+    {
+        return check_satisfiability(std::vector<expression<bool>>{});
     }
-}
+    satisfiability expression_solver::check_satisfiability(expression<bool> const& assumption) const
+    {
+        model_suppression const suppression(models_requested_);
+
+        return solve(assumption).status;
+    }
+    satisfiability expression_solver::check_satisfiability(std::vector<expression<bool>> const& assumptions) const
+    {
+        model_suppression const suppression(models_requested_);
+
+        return solve(assumptions).status;
+    }
+
+    check_result expression_solver::solve() const
+    {
+        return solve(std::vector<expression<bool>>{});
+    }
+    check_result expression_solver::solve(expression<bool> const& assumption) const
+    {
+        return solve(assumption, limits_);
+    }
+    check_result expression_solver::solve(std::vector<expression<bool>> const& assumptions) const
+    {
+        return solve(assumptions, limits_);
+    }
+    check_result expression_solver::solve(expression<bool> const& assumption, solver_limits const& limits) const
+    {
+        if (&assumption.base_.context() != &base_->context())
+            throw std::logic_error("Invalid context");
+
+        assumption.observe();
+
+        if (auto result = check_trivial(std::span(&assumption, 1)); result.has_value())
+            return std::move(*result);
+
+        apply_limits(limits);
+
+        if (slicing_mode_ == slicing_mode::independence)
+            return check_slices(assumption.base());
+
+        return check_formula(assumption.base());
+    }
+    check_result expression_solver::solve(std::vector<expression<bool>> const& assumptions, solver_limits const& limits) const
+    {
+        for (auto const& assumption : assumptions)
+        {
+            if (&assumption.base_.context() != &base_->context())
+                throw std::logic_error("Invalid context");
+
+            assumption.observe();
+        }
+
+        if (auto result = check_trivial(assumptions); result.has_value())
+            return std::move(*result);
+
+        std::vector<_Z3_ast*> assumption_resources;
+        assumption_resources.reserve(assumptions.size());
+        for (auto const& assumption : assumptions)
+            assumption_resources.push_back(assumption.base());
+
+        std::vector<z3_ast> constraints;
+        if (counterexample_capacity_ != 0)
+        {
+            for (auto const& assumption : assumptions)
+            {
+                auto const assumption_conjuncts = conjuncts(assumption.base());
+                constraints.insert(constraints.end(), assumption_conjuncts.begin(), assumption_conjuncts.end());
+            }
+            constraints = ordered(std::move(constraints));
+
+            if (auto result = recall(constraints); result.has_value())
+                return std::move(*result);
+        }
+
+        apply_limits(limits);
+
+        release_prefix();
+
+        auto result = check_assumptions(assumption_resources);
+
+        remember(constraints, result);
+
+        return result;
+    }
+
+    template <integral_expression_typename T>
+    std::optional<std::pair<T, T>> expression_solver::range(expression<T> const& value) const
+    {
+        if (&value.base_.context() != &base_->context())
+            throw std::logic_error("Invalid context");
+
+        value.observe();
+
+        return constrained_range(value, z3_ast(base_->context(), Z3_mk_true));
+    }
+    template <integral_expression_typename T>
+    std::optional<std::pair<T, T>> expression_solver::range(expression<T> const& value, expression<bool> const& constraint) const
+    {
+        if (&value.base_.context() != &base_->context() || &constraint.base_.context() != &base_->context())
+            throw std::logic_error("Invalid context");
+
+        value.observe();
+        constraint.observe();
+
+        if (analysis_.decide(constraint) == false)
+            return std::nullopt;
+
+        return constrained_range(value, constraint.base());
+    }
+    template <integral_expression_typename T>
+    std::optional<std::pair<T, T>> expression_solver::constrained_range(expression<T> const& value, z3_ast const& constraint) const
+    {
+        // Bits known beforehand need not be searched for
+        auto const bounds = analysis_.bounds(value);
+
+        auto const& context = base_->context();
+
+        // Signed values are ordered like unsigned ones with their sign bit flipped
+        static constexpr std::uint64_t sign_flip = std::is_signed_v<T> ? std::uint64_t{1} << (sizeof(T) * CHAR_BIT - 1) : 0;
+        z3_ast const ordered = sign_flip == 0
+            ? value.base()
+            : z3_ast(context, Z3_mk_bvxor, value.base(), z3_ast(context, Z3_mk_unsigned_int64, sign_flip, z3_sort(context, Z3_get_sort, value.base())));
+        auto const ordered_zeros = (bounds.known_zeros & ~sign_flip) | (bounds.known_ones & sign_flip);
+        auto const ordered_ones = (bounds.known_ones & ~sign_flip) | (bounds.known_zeros & sign_flip);
+
+        release_prefix();
+
+        apply_limits(limits_);
+
+        auto const maximum = maximize(ordered, constraint, ordered_zeros, ordered_ones);
+        if (!maximum.has_value())
+            return std::nullopt;
+        // The lowest value is the complement of the highest complement
+        auto const minimum = maximize(z3_ast(context, Z3_mk_bvnot, ordered), constraint, ordered_ones, ordered_zeros);
+        if (!minimum.has_value())
+            return std::nullopt;
+
+        using bits = std::conditional_t<std::is_same_v<T, std::byte>, unsigned char, std::make_unsigned_t<T>>;
+        return std::pair(
+            static_cast<T>(static_cast<bits>(~*minimum ^ sign_flip)),
+            static_cast<T>(static_cast<bits>(*maximum ^ sign_flip)));
+    }
+
+    check_task expression_solver::solve_async(expression<bool> const& assumption) const
+    {
+        return solve_async(std::vector{assumption});
+    }
+    check_task expression_solver::solve_async(std::vector<expression<bool>> const& assumptions) const
+    {
+        for (auto const& assumption : assumptions)
+        {
+            if (&assumption.base_.context() != &base_->context())
+                throw std::logic_error("Invalid context");
+
+            assumption.observe();
+        }
+
+        auto task_state = std::make_unique<check_task::state>(base_->context(), assertions_);
+        configure(task_state->solver, limits_, model_generation_);
+        task_state->model_generation = model_generation_;
+
+        task_state->assumptions.reserve(assumptions.size());
+        for (auto const& assumption : assumptions)
+        {
+            task_state->assumptions.emplace_back(
+                task_state->context,
+                [&assumption](_Z3_context* const target)
+                {
+                    return Z3_translate(assumption.base_.context(), assumption.base(), target);
+                });
+        }
+
+        task_state->outcome = std::async(
+            std::launch::async,
+            [task_state = task_state.get()]
+            {
+                if (task_state->cancelled)
+                    return Z3_L_UNDEF;
+
+                std::vector<_Z3_ast*> assumption_resources(task_state->assumptions.begin(), task_state->assumptions.end());
+
+                return task_state->solver.apply(Z3_solver_check_assumptions, static_cast<unsigned>(assumption_resources.size()), assumption_resources.data());
+            });
+
+        return check_task(std::move(task_state));
+    }
+
+    std::vector<check_result> expression_solver::solve_batch(std::span<expression<bool> const> const formulas, std::size_t worker_count) const
+    {
+        for (auto const& formula : formulas)
+        {
+            if (&formula.base_.context() != &base_->context())
+                throw std::logic_error("Invalid context");
+
+            // Build all terms up front, as workers must not modify the formulas
+            formula.observe();
+            static_cast<void>(formula.base());
+        }
+
+        std::vector<check_result> results(formulas.size());
+
+        std::vector<std::size_t> pending;
+        for (std::size_t index = 0; index < formulas.size(); ++index)
+        {
+            if (auto result = check_trivial(formulas.subspan(index, 1)); result.has_value())
+                results[index] = std::move(*result);
+            else
+                pending.push_back(index);
+        }
+
+        if (worker_count == 0)
+            worker_count = std::max(std::thread::hardware_concurrency(), 1U);
+        worker_count = std::min(worker_count, pending.size());
+
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<std::size_t> indices;
+        };
+        std::vector<queue> queues(worker_count);
+        for (std::size_t position = 0; position < pending.size(); ++position)
+            queues[position % worker_count].indices.push_back(pending[position]);
+
+        auto const take = [&queues](std::size_t const worker_index) -> std::optional<std::size_t>
+        {
+            // Own formulas from the front, those of others from the back
+            for (std::size_t offset = 0; offset < queues.size(); ++offset)
+            {
+                auto& current_queue = queues[(worker_index + offset) % queues.size()];
+
+                std::scoped_lock const lock(current_queue.mutex);
+                if (current_queue.indices.empty())
+                    continue;
+
+                std::size_t index{};
+                if (offset == 0)
+                {
+                    index = current_queue.indices.front();
+                    current_queue.indices.pop_front();
+                }
+                else
+                {
+                    index = current_queue.indices.back();
+                    current_queue.indices.pop_back();
+                }
+
+                return index;
+            }
+
+            return std::nullopt;
+        };
+
+        auto const& origin = base_->context();
+        // Guards the context of the solver, which workers translate from and to
+        std::mutex origin_mutex;
+
+        auto const work = [this, &formulas, &results, &take, &origin, &origin_mutex](std::size_t const worker_index)
+        {
+            z3_context const context;
+
+            // Z3 declines to translate solvers within scopes
+            auto const solver = std::make_unique<z3_solver>(context, Z3_mk_simple_solver);
+            {
+                std::scoped_lock const lock(origin_mutex);
+
+                for (auto const& assertion : assertions_)
+                    solver->apply(Z3_solver_assert, z3_ast(context, Z3_translate(origin, assertion, context)));
+            }
+            configure(*solver, limits_, model_generation_);
+
+            while (auto const index = take(worker_index))
+            {
+                auto const& formula = formulas[*index];
+
+                std::unique_ptr<z3_ast> translated_formula;
+                {
+                    std::scoped_lock const lock(origin_mutex);
+
+                    translated_formula = std::make_unique<z3_ast>(
+                        context,
+                        [&formula, &origin](_Z3_context* const target)
+                        {
+                            return Z3_translate(origin, formula.base(), target);
+                        });
+                }
+
+                auto* const formula_resource = static_cast<_Z3_ast*>(*translated_formula);
+                switch (solver->apply(Z3_solver_check_assumptions, 1U, &formula_resource))
+                {
+                case Z3_L_FALSE:
+                    results[*index] = {satisfiability::unsatisfiable, std::nullopt};
+                    break;
+                case Z3_L_TRUE:
+                {
+                    if (!model_generation_)
+                    {
+                        results[*index] = {satisfiability::satisfiable, std::nullopt};
+                        break;
+                    }
+
+                    z3_model const model(context, solver->apply(Z3_solver_get_model));
+
+                    std::scoped_lock const lock(origin_mutex);
+
+                    results[*index] =
+                    {
+                        satisfiability::satisfiable,
+                        expression_model(
+                            z3_model(
+                                origin,
+                                [&context, &model](_Z3_context* const target)
+                                {
+                                    return Z3_model_translate(context, model, target);
+                                }))
+                    };
+                    break;
+                }
+
+                default:
+                    break;
+                }
+            }
+        };
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(worker_count);
+            for (std::size_t worker_index = 0; worker_index < worker_count; ++worker_index)
+                workers.emplace_back(work, worker_index);
+        }
+
+        return results;
+    }
+
+    std::optional<check_result> expression_solver::check_trivial(std::span<expression<bool> const> const assumptions) const
+    {
+        auto decided = true;
+        for (auto const& assumption : assumptions)
+        {
+            std::optional<bool> truth;
+            if (auto const value = assumption.value(); value.has_value())
+                truth = *value != 0;
+            else
+                truth = analysis_.decide(assumption);
+
+            if (truth == false)
+            {
+                ++trivial_hits_;
+                return check_result{satisfiability::unsatisfiable, std::nullopt};
+            }
+
+            decided &= truth.has_value();
+        }
+
+        // Assertions still have to be checked
+        if (!decided || !assertions_.empty())
+            return std::nullopt;
+
+        ++trivial_hits_;
+
+        if (!generates_models())
+            return check_result{satisfiability::satisfiable, std::nullopt};
+
+        if (!empty_model_.has_value())
+            empty_model_ = expression_model(z3_model(base_->context(), Z3_mk_model));
+
+        return check_result{satisfiability::satisfiable, empty_model_};
+    }
+
+    check_result expression_solver::check_slices(z3_ast const& formula) const
+    {
+        auto const& context = base_->context();
+
+        auto const formula_conjuncts = conjuncts(formula);
+
+        // Union-find over the conjuncts, followed by the assertions
+        auto const assertion_index = formula_conjuncts.size();
+        std::vector<std::size_t> parents(assertion_index + 1);
+        std::iota(parents.begin(), parents.end(), std::size_t{});
+        auto const find = [&parents](std::size_t index)
+        {
+            while (parents[index] != index)
+                index = parents[index] = parents[parents[index]];
+
+            return index;
+        };
+
+        std::unordered_map<symbol_id, std::size_t> symbol_owners;
+        for (auto const id : assertion_dependencies_)
+            symbol_owners.emplace(id, assertion_index);
+        // Memory reads may alias one another
+        std::optional<std::size_t> memory_owner;
+        if (assertion_indirect_)
+            memory_owner = assertion_index;
+
+        std::vector<std::vector<symbol_id>> conjunct_dependencies;
+        conjunct_dependencies.reserve(assertion_index);
+        for (std::size_t index = 0; index < assertion_index; ++index)
+        {
+            expression<> const conjunct(formula_conjuncts[index]);
+
+            for (auto const id : conjunct_dependencies.emplace_back(conjunct.dependency_ids()))
+            {
+                if (auto const [owner, inserted] = symbol_owners.emplace(id, index); !inserted)
+                    parents[find(index)] = find(owner->second);
+            }
+
+            if (conjunct.dependencies_indirect().empty())
+                continue;
+
+            if (memory_owner.has_value())
+                parents[find(index)] = find(*memory_owner);
+            else
+                memory_owner = index;
+        }
+
+        struct slice
+        {
+            std::vector<_Z3_ast*> conjuncts;
+            std::vector<symbol_id> dependencies;
+            bool anchored{};
+            bool indirect{};
+        };
+        std::vector<slice> slices;
+        std::unordered_map<std::size_t, std::size_t> slice_indices;
+        for (std::size_t index = 0; index < assertion_index; ++index)
+        {
+            auto const root = find(index);
+
+            auto const [slice_index, inserted] = slice_indices.emplace(root, slices.size());
+            if (inserted)
+            {
+                slices.push_back(
+                    {
+                        .conjuncts = {},
+                        .dependencies = {},
+                        .anchored = root == find(assertion_index),
+                        .indirect = memory_owner.has_value() && root == find(*memory_owner)
+                    });
+            }
+
+            auto& current_slice = slices[slice_index->second];
+            current_slice.conjuncts.push_back(formula_conjuncts[index]);
+            current_slice.dependencies.insert(current_slice.dependencies.end(), conjunct_dependencies[index].begin(), conjunct_dependencies[index].end());
+        }
+
+        if (slices.size() <= 1)
+            return check_formula(formula);
+
+        std::size_t satisfiable_count{};
+        std::vector<expression_model> models;
+        models.reserve(slices.size());
+        for (auto const& current_slice : slices)
+        {
+            auto const slice_formula = current_slice.conjuncts.size() == 1
+                ? z3_ast(context, current_slice.conjuncts.front())
+                : z3_ast(context, Z3_mk_and, static_cast<unsigned>(current_slice.conjuncts.size()), current_slice.conjuncts.data());
+
+            auto result = check_formula(slice_formula);
+            switch (result.status)
+            {
+            case satisfiability::unsatisfiable:
+                return result;
+            case satisfiability::satisfiable:
+                ++satisfiable_count;
+                if (result.model.has_value())
+                    models.push_back(std::move(*result.model));
+                break;
+
+            default:
+                // A later slice may still turn out unsatisfiable
+                break;
+            }
+        }
+        if (satisfiable_count != slices.size())
+            return {};
+        if (models.size() != slices.size())
+            return {satisfiability::satisfiable, std::nullopt};
+
+        // Only constants are transferred, so start out with the model that interprets memory
+        std::size_t base_slice = 0;
+        while (base_slice < slices.size() - 1 && !slices[base_slice].indirect)
+            ++base_slice;
+        auto const& base_model = *models[base_slice].base_;
+        z3_model merged_model(
+            context,
+            [&base_model](_Z3_context* const raw_context)
+            {
+                return Z3_model_translate(raw_context, base_model, raw_context);
+            });
+
+        for (std::size_t slice_index = 0; slice_index < slices.size(); ++slice_index)
+        {
+            if (slice_index == base_slice)
+                continue;
+
+            // Slices related to the assertions take along the assertion symbols, whose values depend on one another
+            std::unordered_set<_Z3_symbol*> symbols;
+            for (auto const id : slices[slice_index].dependencies)
+                symbols.insert(z3_symbol_table::instance().symbol(id));
+            if (slices[slice_index].anchored)
+            {
+                for (auto const id : assertion_dependencies_)
+                    symbols.insert(z3_symbol_table::instance().symbol(id));
+            }
+
+            auto const& model = *models[slice_index].base_;
+            auto const constant_count = model.apply(Z3_model_get_num_consts);
+            for (auto constant_index = 0U; constant_index < constant_count; ++constant_index)
+            {
+                auto* const declaration = model.apply(Z3_model_get_const_decl, constant_index);
+                if (!symbols.contains(Z3_get_decl_name(context, declaration)))
+                    continue;
+
+                merged_model.apply(Z3_add_const_interp, declaration, model.apply(Z3_model_get_const_interp, declaration));
+            }
+        }
+
+        return {satisfiability::satisfiable, expression_model(std::move(merged_model))};
+    }
+    check_result expression_solver::check_formula(z3_ast const& formula) const
+    {
+        if (cache_capacity_ == 0)
+            return recall_formula(formula);
+
+        if (auto const entry = cache_index_.find(formula); entry != cache_index_.end())
+        {
+            ++cache_hits_;
+
+            cache_entries_.splice(cache_entries_.begin(), cache_entries_, entry->second);
+
+            return entry->second->second;
+        }
+
+        ++cache_misses_;
+
+        auto result = recall_formula(formula);
+        if (result.status == satisfiability::unknown || (result.status == satisfiability::satisfiable && !result.model.has_value()))
+            return result;
+
+        cache_entries_.emplace_front(formula, result);
+        cache_index_.emplace(formula, cache_entries_.begin());
+
+        // Evict the least recently used
+        if (cache_entries_.size() > cache_capacity_)
+        {
+            cache_index_.erase(cache_entries_.back().first);
+            cache_entries_.pop_back();
+        }
+
+        return result;
+    }
+    check_result expression_solver::recall_formula(z3_ast const& formula) const
+    {
+        if (counterexample_capacity_ == 0)
+            return solve_formula(formula);
+
+        auto const constraints = ordered(conjuncts(formula));
+        if (auto result = recall(constraints); result.has_value())
+            return std::move(*result);
+
+        auto result = solve_formula(formula);
+
+        remember(constraints, result);
+
+        return result;
+    }
+    check_result expression_solver::solve_formula(z3_ast const& formula) const
+    {
+        if (query_mode_ != query_mode::prefix_sharing)
+        {
+            release_prefix();
+
+            return check_assumptions({formula});
+        }
+
+        auto const formula_conjuncts = conjuncts(formula);
+
+        // Keep the conjuncts shared with the previous formula
+        auto const mismatch = std::mismatch(prefix_.begin(), prefix_.end(), formula_conjuncts.begin(), formula_conjuncts.end(),
+            [](z3_ast const& conjunct_1, z3_ast const& conjunct_2)
+            {
+                return static_cast<_Z3_ast*>(conjunct_1) == static_cast<_Z3_ast*>(conjunct_2);
+            });
+        if (mismatch.first != prefix_.end())
+        {
+            base_->apply(Z3_solver_pop, static_cast<unsigned>(prefix_.end() - mismatch.first));
+            prefix_.erase(mismatch.first, prefix_.end());
+        }
+
+        for (auto conjunct = mismatch.second; conjunct != formula_conjuncts.end(); ++conjunct)
+        {
+            base_->apply(Z3_solver_push);
+            base_->apply(Z3_solver_assert, *conjunct);
+
+            prefix_.push_back(*conjunct);
+        }
+
+        return check_assumptions({});
+    }
+    check_result expression_solver::check_assumptions(std::vector<_Z3_ast*> const& assumptions) const
+    {
+        if (split_depth_ != 0)
+            return check_cubes(assumptions);
+        if (!portfolio_.empty())
+            return check_portfolio(assumptions);
+
+        return check_base(assumptions);
+    }
+    check_result expression_solver::check_base(std::vector<_Z3_ast*> const& assumptions) const
+    {
+        switch (base_->apply(Z3_solver_check_assumptions, static_cast<unsigned>(assumptions.size()), assumptions.data()))
+        {
+        case Z3_L_FALSE:
+            return {satisfiability::unsatisfiable, std::nullopt};
+        case Z3_L_TRUE:
+            if (!generates_models())
+                return {satisfiability::satisfiable, std::nullopt};
+
+            return {satisfiability::satisfiable, expression_model(z3_model(base_->context(), base_->apply(Z3_solver_get_model)))};
+
+        default:
+            return {};
+        }
+    }
+
+    std::optional<std::uint64_t> expression_solver::maximize(z3_ast const& term, z3_ast const& constraint, std::uint64_t const known_zeros, std::uint64_t const known_ones) const
+    {
+        auto const& context = base_->context();
+
+        z3_sort const sort(context, Z3_get_sort, term);
+        auto const width = sort.apply(Z3_get_bv_sort_size);
+
+        // A reachable value not below the candidate, if any; without models, the candidate itself
+        auto const reach = [this, &context, &term, &constraint, &sort](std::optional<std::uint64_t> const candidate) -> std::optional<std::uint64_t>
+        {
+            std::vector<z3_ast> assumptions{constraint};
+            if (candidate.has_value())
+                assumptions.emplace_back(context, Z3_mk_bvuge, term, z3_ast(context, Z3_mk_unsigned_int64, *candidate, sort));
+
+            std::vector<_Z3_ast*> assumption_resources(assumptions.begin(), assumptions.end());
+            switch (base_->apply(Z3_solver_check_assumptions, static_cast<unsigned>(assumption_resources.size()), assumption_resources.data()))
+            {
+            case Z3_L_FALSE:
+                return std::nullopt;
+            case Z3_L_TRUE:
+                break;
+
+            default:
+                throw std::logic_error("Invalid expression");
+            }
+
+            if (!model_generation_)
+                return candidate.value_or(0);
+
+            z3_model const model(context, base_->apply(Z3_solver_get_model));
+
+            _Z3_ast* value_resource{};
+            if (!model.apply(Z3_model_eval, term, true, &value_resource))
+                return candidate.value_or(0);
+            z3_ast const value(context, value_resource);
+
+            std::uint64_t reached{};
+            if (!value.apply(Z3_get_numeral_uint64, &reached))
+                return candidate.value_or(0);
+
+            return reached;
+        };
+
+        auto const initial = reach(std::nullopt);
+        if (!initial.has_value())
+            return std::nullopt;
+
+        auto maximum = *initial | known_ones;
+        for (auto bit = width; bit-- > 0;)
+        {
+            auto const bit_mask = std::uint64_t{1} << bit;
+            if ((maximum & bit_mask) != 0 || (known_zeros & bit_mask) != 0)
+                continue;
+
+            // Higher bits as reached so far, this one set and the lower ones cleared
+            auto const candidate = (maximum & ~((bit_mask << 1U) - 1)) | bit_mask;
+            if (auto const reached = reach(candidate); reached.has_value())
+                maximum = *reached;
+        }
+
+        return maximum;
+    }
+
+    bool expression_solver::generates_models() const noexcept
+    {
+        return model_generation_ && models_requested_;
+    }
+
+    std::vector<_Z3_ast*> expression_solver::asserted(std::vector<_Z3_ast*> const& assumptions) const
+    {
+        std::vector<_Z3_ast*> formulas(assumptions);
+        formulas.insert(formulas.end(), assertions_.begin(), assertions_.end());
+        formulas.insert(formulas.end(), prefix_.begin(), prefix_.end());
+
+        return formulas;
+    }
+
+    check_result expression_solver::check_portfolio(std::vector<_Z3_ast*> const& assumptions) const
+    {
+        auto const& origin = base_->context();
+        auto const formulas = asserted(assumptions);
+
+        std::vector<std::unique_ptr<replica>> replicas;
+        replicas.reserve(portfolio_.size());
+        for (auto const& configuration : portfolio_)
+            replicas.push_back(replicate(origin, formulas, configuration, applied_limits_, model_generation_));
+
+        std::mutex mutex;
+        std::condition_variable finish;
+        std::optional<std::size_t> winner;
+
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(replicas.size());
+            for (std::size_t index = 0; index < replicas.size(); ++index)
+            {
+                threads.emplace_back(
+                    [&replicas, &mutex, &finish, &winner, index]
+                    {
+                        auto& current = *replicas[index];
+
+                        auto const outcome = current.solver->apply(Z3_solver_check);
+
+                        std::scoped_lock const lock(mutex);
+
+                        current.outcome = outcome;
+                        current.finished = true;
+                        if (outcome != Z3_L_UNDEF && !winner.has_value())
+                            winner = index;
+
+                        finish.notify_all();
+                    });
+            }
+
+            std::unique_lock lock(mutex);
+            finish.wait(lock,
+                [&replicas, &winner]
+                {
+                    return winner.has_value() || finished(replicas);
+                });
+
+            interrupt(replicas, lock, finish);
+        }
+
+        if (!winner.has_value())
+            return {};
+
+        auto const& current = *replicas[*winner];
+        if (current.outcome == Z3_L_FALSE)
+            return {satisfiability::unsatisfiable, std::nullopt};
+        if (!generates_models())
+            return {satisfiability::satisfiable, std::nullopt};
+
+        return {satisfiability::satisfiable, expression_model(translate_model(current, origin))};
+    }
+    check_result expression_solver::check_cubes(std::vector<_Z3_ast*> const& assumptions) const
+    {
+        auto const& origin = base_->context();
+        auto const formulas = asserted(assumptions);
+
+        auto const literals = split_literals(origin, formulas, split_depth_);
+        // Nothing to split on
+        if (literals.empty())
+            return check_base(assumptions);
+
+        std::size_t const cube_count = std::size_t{1} << literals.size();
+        auto const worker_count = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U), cube_count);
+
+        std::vector<std::unique_ptr<replica>> replicas;
+        std::vector<std::vector<z3_ast>> replica_literals;
+        replicas.reserve(worker_count);
+        replica_literals.reserve(worker_count);
+        for (std::size_t index = 0; index < worker_count; ++index)
+        {
+            auto const& current = *replicas.emplace_back(replicate(origin, formulas, solver_configuration{}, applied_limits_, model_generation_));
+
+            auto& current_literals = replica_literals.emplace_back();
+            for (auto const& literal : literals)
+                current_literals.emplace_back(current.context, Z3_translate(origin, literal, current.context));
+        }
+
+        std::mutex mutex;
+        std::condition_variable finish;
+        std::optional<std::size_t> winner;
+        bool undecided{};
+        std::size_t next_cube{};
+
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(replicas.size());
+            for (std::size_t index = 0; index < replicas.size(); ++index)
+            {
+                threads.emplace_back(
+                    [&replicas, &replica_literals, &mutex, &finish, &winner, &undecided, &next_cube, cube_count, index]
+                    {
+                        auto& current = *replicas[index];
+                        auto const& context = current.context;
+
+                        while (true)
+                        {
+                            std::size_t cube{};
+                            {
+                                std::scoped_lock const lock(mutex);
+
+                                if (winner.has_value() || next_cube == cube_count)
+                                {
+                                    current.finished = true;
+                                    finish.notify_all();
+                                    return;
+                                }
+
+                                cube = next_cube++;
+                            }
+
+                            // Each bit of the cube index selects the polarity of a literal
+                            std::vector<z3_ast> cube_literals;
+                            for (std::size_t literal_index = 0; literal_index < replica_literals[index].size(); ++literal_index)
+                            {
+                                auto const& literal = replica_literals[index][literal_index];
+                                if (((cube >> literal_index) & 1U) != 0)
+                                    cube_literals.push_back(literal);
+                                else
+                                    cube_literals.emplace_back(context, Z3_mk_not, literal);
+                            }
+                            std::vector<_Z3_ast*> cube_resources(cube_literals.begin(), cube_literals.end());
+
+                            auto const outcome = current.solver->apply(Z3_solver_check_assumptions, static_cast<unsigned>(cube_resources.size()), cube_resources.data());
+
+                            std::scoped_lock const lock(mutex);
+
+                            current.outcome = outcome;
+                            if (outcome == Z3_L_TRUE && !winner.has_value())
+                                winner = index;
+                            if (outcome == Z3_L_UNDEF)
+                                undecided = true;
+                        }
+                    });
+            }
+
+            std::unique_lock lock(mutex);
+            finish.wait(lock,
+                [&replicas, &winner]
+                {
+                    return winner.has_value() || finished(replicas);
+                });
+
+            interrupt(replicas, lock, finish);
+        }
+
+        if (winner.has_value() && !generates_models())
+            return {satisfiability::satisfiable, std::nullopt};
+        if (winner.has_value())
+            return {satisfiability::satisfiable, expression_model(translate_model(*replicas[*winner], origin))};
+        if (undecided)
+            return {};
+
+        return {satisfiability::unsatisfiable, std::nullopt};
+    }
+
+    std::optional<check_result> expression_solver::recall(std::vector<z3_ast> const& constraints) const
+    {
+        for (auto const& unsatisfiable_set : unsatisfiable_sets_)
+        {
+            if (std::includes(constraints.begin(), constraints.end(), unsatisfiable_set.begin(), unsatisfiable_set.end(), precedes))
+            {
+                ++counterexample_hits_;
+
+                return check_result{satisfiability::unsatisfiable, std::nullopt};
+            }
+        }
+
+        for (auto model = counterexamples_.begin(); model != counterexamples_.end(); ++model)
+        {
+            auto const satisfied = std::all_of(constraints.begin(), constraints.end(),
+                [&model](z3_ast const& constraint)
+                {
+                    _Z3_ast* application_resource{};
+                    if (!model->base_->apply(Z3_model_eval, constraint, false, &application_resource))
+                        return false;
+
+                    return z3_ast(model->base_->context(), application_resource).apply(Z3_get_bool_value) == Z3_L_TRUE;
+                });
+            if (satisfied)
+            {
+                ++counterexample_hits_;
+
+                counterexamples_.splice(counterexamples_.begin(), counterexamples_, model);
+
+                return check_result{satisfiability::satisfiable, counterexamples_.front()};
+            }
+        }
+
+        return std::nullopt;
+    }
+    void expression_solver::remember(std::vector<z3_ast> const& constraints, check_result const& result) const
+    {
+        if (counterexample_capacity_ == 0)
+            return;
+
+        switch (result.status)
+        {
+        case satisfiability::unsatisfiable:
+            unsatisfiable_sets_.push_front(constraints);
+            if (unsatisfiable_sets_.size() > counterexample_capacity_)
+                unsatisfiable_sets_.pop_back();
+            break;
+        case satisfiability::satisfiable:
+            if (!result.model.has_value())
+                break;
+
+            counterexamples_.push_front(*result.model);
+            if (counterexamples_.size() > counterexample_capacity_)
+                counterexamples_.pop_back();
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void expression_solver::clear_cache() noexcept
+    {
+        cache_index_.clear();
+        cache_entries_.clear();
+    }
+
+    void expression_solver::apply_limits(solver_limits const& limits) const noexcept
+    {
+        if (limits.timeout == applied_limits_.timeout && limits.resource_limit == applied_limits_.resource_limit)
+            return;
+
+        configure(*base_, limits, model_generation_);
+
+        applied_limits_ = limits;
+    }
+
+    void expression_solver::release_prefix() const noexcept
+    {
+        if (prefix_.empty())
+            return;
+
+        base_->apply(Z3_solver_pop, static_cast<unsigned>(prefix_.size()));
+        prefix_.clear();
+    }
+}
+
+// NOLINTNEXTLINE [cppcoreguidelines-macro-usage]
+#define EXPRESSION(T) expression<TYPE(T)>
+
+// NOLINTNEXTLINE [cppcoreguidelines-macro-usage]
+#define INSTANTIATE_RANGE(T) \
+    template std::optional<std::pair<TYPE(T), TYPE(T)>> fml::expression_solver::range(EXPRESSION(T) const&) const; \
+    template std::optional<std::pair<TYPE(T), TYPE(T)>> fml::expression_solver::range(EXPRESSION(T) const&, expression<bool> const&) const;
+LOOP_TYPES_0(INSTANTIATE_RANGE);
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <formulae1/expression_substitution.hpp>
+
+#include "preprocessor_types.hpp"
+#include "z3_resource.ipp"
+#include "z3_symbol_table.hpp"
+
+namespace fml
+{
+    using z3_app = z3_resource<_Z3_app>;
+    using z3_sort = z3_resource<_Z3_sort, _Z3_ast, Z3_inc_ref, Z3_dec_ref>;
+
+    struct expression_substitution::state
+    {
+        z3_context const* context{};
+
+        // Ascending
+        std::vector<symbol_id> key_symbols;
+
+        // Rewritten terms by the identifiers of their originals, which are kept alive to retain their identifiers
+        std::unordered_map<unsigned, std::pair<z3_ast, z3_ast>> rewritten;
+
+        [[nodiscard]] z3_ast rewrite(z3_ast const& term);
+    };
+
+    z3_ast expression_substitution::state::rewrite(z3_ast const& root)
+    {
+        // Arguments before their applications, on a stack of its own to cope with deep terms
+        std::vector<std::pair<z3_ast, bool>> pending;
+        pending.emplace_back(root, false);
+        while (!pending.empty())
+        {
+            auto const term = pending.back().first;
+            auto const id = term.apply(Z3_get_ast_id);
+            if (rewritten.contains(id))
+            {
+                pending.pop_back();
+                continue;
+            }
+
+            if (term.apply(Z3_get_ast_kind) != Z3_APP_AST)
+            {
+                rewritten.emplace(id, std::pair(term, term));
+                pending.pop_back();
+                continue;
+            }
+
+            z3_app const application(*context, Z3_to_app, term);
+
+            auto const argument_count = application.apply(Z3_get_app_num_args);
+
+            // Revisited once all arguments are done
+            if (!pending.back().second)
+            {
+                pending.back().second = true;
+
+                for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+                    pending.emplace_back(z3_ast(*context, Z3_get_app_arg, application, argument_index), false);
+
+                continue;
+            }
+
+            std::vector<_Z3_ast*> argument_resources;
+            argument_resources.reserve(argument_count);
+            auto changed = false;
+            for (auto argument_index = 0U; argument_index < argument_count; ++argument_index)
+            {
+                z3_ast const argument(*context, Z3_get_app_arg, application, argument_index);
+
+                auto* const rewritten_argument = static_cast<_Z3_ast*>(rewritten.at(argument.apply(Z3_get_ast_id)).second);
+                argument_resources.push_back(rewritten_argument);
+                changed |= rewritten_argument != static_cast<_Z3_ast*>(argument);
+            }
+
+            auto result = term;
+            if (changed)
+                result = z3_ast(*context, Z3_update_term, term, argument_count, argument_resources.data());
+
+            rewritten.emplace(id, std::pair(term, std::move(result)));
+            pending.pop_back();
+        }
+
+        return rewritten.at(root.apply(Z3_get_ast_id)).second;
+    }
+
+    expression_substitution::expression_substitution(std::unordered_map<std::string, expression<>> const& values) :
+        base_(std::make_unique<state>())
+    {
+        for (auto const& [key_symbol, value] : values)
+        {
+            auto const& context = value.base_.context();
+            if (base_->context == nullptr)
+                base_->context = &context;
+            else if (base_->context != &context)
+                throw std::logic_error("Invalid context");
+
+            auto const key_symbol_id = z3_symbol_table::instance().intern(context, key_symbol);
+
+            z3_ast key(
+                context,
+                Z3_mk_const,
+                z3_symbol_table::instance().symbol(key_symbol_id),
+                z3_sort(context, Z3_get_sort, value.base()));
+
+            base_->key_symbols.push_back(key_symbol_id);
+
+            // Keys are rewritten to their values right away
+            auto const id = key.apply(Z3_get_ast_id);
+            base_->rewritten.emplace(id, std::pair(std::move(key), value.base()));
+        }
+
+        std::sort(base_->key_symbols.begin(), base_->key_symbols.end());
+    }
+
+    expression_substitution::~expression_substitution() noexcept = default;
+
+    expression_substitution::expression_substitution(expression_substitution const& other) :
+        base_(std::make_unique<state>(*other.base_))
+    { }
+    expression_substitution& expression_substitution::operator=(expression_substitution const& other)
+    {
+        if (&other != this)
+            base_ = std::make_unique<state>(*other.base_);
+
+        return *this;
+    }
+
+    expression_substitution::expression_substitution(expression_substitution&&) noexcept = default;
+    expression_substitution& expression_substitution::operator=(expression_substitution&&) noexcept = default;
+
+    template <typename T>
+    expression<T> expression_substitution::apply(expression<T> const& value)
+    {
+        if (value.concrete_)
+            return value;
+
+        // Leave unaffected expressions as they are
+        auto const dependencies = value.dependency_ids();
+        if (std::none_of(dependencies.begin(), dependencies.end(),
+                [this](symbol_id const dependency)
+                {
+                    return std::binary_search(base_->key_symbols.begin(), base_->key_symbols.end(), dependency);
+                }))
+        {
+            return value;
+        }
+
+        if (&value.base_.context() != base_->context)
+            throw std::logic_error("Invalid context");
+
+        expression<T> result(base_->rewrite(value.base_));
+        result.simplify();
+
+        return result;
+    }
+}
+
+// NOLINTNEXTLINE [cppcoreguidelines-macro-usage]
+#define EXPRESSION(T) expression<TYPE(T)>
+
+template fml::expression<> fml::expression_substitution::apply(expression<> const&);
+template fml::expression<bool> fml::expression_substitution::apply(expression<bool> const&);
+
+// NOLINTNEXTLINE [cppcoreguidelines-macro-usage]
+#define INSTANTIATE_APPLY(T) \
+    template fml::EXPRESSION(T) fml::expression_substitution::apply(EXPRESSION(T) const&);
+LOOP_TYPES_0(INSTANTIATE_APPLY);
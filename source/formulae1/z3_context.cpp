@@ -1,14 +1,20 @@
-#include "z3_context.hpp"
+#include <formulae1/expression_context.hpp>
+
 #include "z3_configuration.hpp"
+#include "z3_context.hpp"
 
 namespace fml
 {
     z3_context::z3_context() noexcept :
-        base_(Z3_mk_context_rc(z3_configuration()))
+        base_(Z3_mk_context_rc(z3_configuration())),
+        simplification_mode_(simplification_mode::eager),
+        dependency_cache_capacity_(0)
     { }
 
     z3_context::~z3_context() noexcept
     {
+        evict_dependencies(0);
+
         Z3_del_context(base_);
     }
 
@@ -17,10 +23,75 @@ namespace fml
         return base_;
     }
 
-    z3_context const& z3_context::instance() noexcept
+    void z3_context::select_simplification_mode(simplification_mode const mode) noexcept
+    {
+        simplification_mode_ = mode;
+    }
+    simplification_mode z3_context::selected_simplification_mode() const noexcept
+    {
+        return simplification_mode_;
+    }
+
+    void z3_context::select_dependency_cache_capacity(std::size_t const capacity) noexcept
+    {
+        dependency_cache_capacity_ = capacity;
+
+        evict_dependencies(dependency_cache_capacity_);
+    }
+    std::size_t z3_context::selected_dependency_cache_capacity() const noexcept
+    {
+        return dependency_cache_capacity_;
+    }
+
+    std::vector<symbol_id> const* z3_context::find_dependencies(_Z3_ast* const term) const noexcept
+    {
+        if (dependency_index_.empty())
+            return nullptr;
+
+        auto const entry = dependency_index_.find(Z3_get_ast_id(base_, term));
+        if (entry == dependency_index_.end())
+            return nullptr;
+
+        dependency_entries_.splice(dependency_entries_.begin(), dependency_entries_, entry->second);
+
+        return &entry->second->second;
+    }
+    void z3_context::store_dependencies(_Z3_ast* const term, std::vector<symbol_id> const& dependencies) const noexcept
     {
-        static z3_context const context;
+        if (dependency_cache_capacity_ == 0)
+            return;
+
+        auto const id = Z3_get_ast_id(base_, term);
+        if (dependency_index_.contains(id))
+            return;
 
-        return context;
+        // Evict the least recently used
+        evict_dependencies(dependency_cache_capacity_ - 1);
+
+        Z3_inc_ref(base_, term);
+        dependency_entries_.emplace_front(term, dependencies);
+        dependency_index_.emplace(id, dependency_entries_.begin());
+    }
+
+    void z3_context::evict_dependencies(std::size_t const capacity) const noexcept
+    {
+        while (dependency_entries_.size() > capacity)
+        {
+            auto const term = dependency_entries_.back().first;
+
+            dependency_index_.erase(Z3_get_ast_id(base_, term));
+            dependency_entries_.pop_back();
+
+            Z3_dec_ref(base_, term);
+        }
+    }
+
+    z3_context const& z3_context::instance() noexcept
+    {
+        return instance(expression_context::current());
+    }
+    z3_context const& z3_context::instance(expression_context const& context) noexcept
+    {
+        return *context.base_;
     }
 }
@@ -1,19 +1,31 @@
 #pragma once
 
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <z3.h>
 
+#include <formulae1/expression_context.hpp>
+#include <formulae1/expression_symbol.hpp>
+
 namespace fml
 {
     class z3_context
     {
-        template <typename, typename ValueBase, void(_Z3_context*, ValueBase*), void(_Z3_context*, ValueBase*)>
-        friend class z3_resource;
-
         _Z3_context* base_;
 
-        z3_context() noexcept;
+        simplification_mode simplification_mode_;
+
+        std::size_t dependency_cache_capacity_;
+        // Symbol dependencies of terms, most recently used first; the terms are referenced to retain their ids
+        mutable std::list<std::pair<_Z3_ast*, std::vector<symbol_id>>> dependency_entries_;
+        mutable std::unordered_map<unsigned, decltype(dependency_entries_)::iterator> dependency_index_;
 
     public:
+        z3_context() noexcept;
+
         ~z3_context() noexcept;
 
         z3_context(z3_context const&) = delete;
@@ -25,7 +37,20 @@ namespace fml
         // NOLINTNEXTLINE [hicpp-explicit-conversions]
         [[nodiscard]] operator _Z3_context*() const noexcept;
 
-    private:
+        void select_simplification_mode(simplification_mode) noexcept;
+        [[nodiscard]] simplification_mode selected_simplification_mode() const noexcept;
+
+        void select_dependency_cache_capacity(std::size_t) noexcept;
+        [[nodiscard]] std::size_t selected_dependency_cache_capacity() const noexcept;
+
+        [[nodiscard]] std::vector<symbol_id> const* find_dependencies(_Z3_ast*) const noexcept;
+        void store_dependencies(_Z3_ast*, std::vector<symbol_id> const&) const noexcept;
+
+        // Context of the calling thread, depending on the selected context mode
         [[nodiscard]] static z3_context const& instance() noexcept;
+        [[nodiscard]] static z3_context const& instance(expression_context const&) noexcept;
+
+    private:
+        void evict_dependencies(std::size_t) const noexcept;
     };
 }
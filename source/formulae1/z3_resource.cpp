@@ -1 +1 @@
-#include "z3_resource.hpp"
+#include <formulae1/z3_resource.hpp>
@@ -1,5 +1,6 @@
+#include <formulae1/z3_resource.hpp>
+
 #include "z3_context.hpp"
-#include "z3_resource.hpp"
 
 namespace fml
 {
@@ -7,54 +8,88 @@ namespace fml
     void z3_resource<Value, ValueBase, INC, DEC>::deleter::deleter::operator()(Value* const value) const noexcept
     {
         // NOLINTNEXTLINE [cppcoreguidelines-pro-type-reinterpret-cast]
-        DEC(z3_context::instance(), reinterpret_cast<ValueBase*>(value));
+        DEC(*context, reinterpret_cast<ValueBase*>(value));
     }
 
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
-    z3_resource<Value, ValueBase, INC, DEC>::pointer::pointer(Value* const value) noexcept :
-        std::unique_ptr<Value, deleter>(value)
+    z3_resource<Value, ValueBase, INC, DEC>::pointer::pointer(z3_context const& context, Value* const value) noexcept :
+        std::unique_ptr<Value, deleter>(value, deleter{&context})
     {
-        // NOLINTNEXTLINE [cppcoreguidelines-pro-type-reinterpret-cast]
-        INC(z3_context::instance(), reinterpret_cast<ValueBase*>(get()));
+        // Empty resources are merely bound to their context
+        if (get() != nullptr)
+        {
+            // NOLINTNEXTLINE [cppcoreguidelines-pro-type-reinterpret-cast]
+            INC(context, reinterpret_cast<ValueBase*>(get()));
+        }
     }
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
-    void z3_resource<Value, ValueBase, INC, DEC>::pointer::reset(Value* const value) noexcept
+    void z3_resource<Value, ValueBase, INC, DEC>::pointer::reset(z3_context const& context, Value* const value) noexcept
     {
+        // Release the previous value within its own context
         std::unique_ptr<Value, deleter>::reset(value);
+        std::unique_ptr<Value, deleter>::get_deleter().context = &context;
 
-        // NOLINTNEXTLINE [cppcoreguidelines-pro-type-reinterpret-cast]
-        INC(z3_context::instance(), reinterpret_cast<ValueBase*>(get()));
+        if (get() != nullptr)
+        {
+            // NOLINTNEXTLINE [cppcoreguidelines-pro-type-reinterpret-cast]
+            INC(context, reinterpret_cast<ValueBase*>(get()));
+        }
+    }
+    template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
+    z3_context const& z3_resource<Value, ValueBase, INC, DEC>::pointer::context() const noexcept
+    {
+        return *std::unique_ptr<Value, deleter>::get_deleter().context;
     }
 
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
     z3_resource<Value, ValueBase, INC, DEC>::z3_resource(Value* const base) noexcept :
-        base_(base)
+        z3_resource(z3_context::instance(), base)
+    { }
+    template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
+    z3_resource<Value, ValueBase, INC, DEC>::z3_resource(z3_context const& context, Value* const base) noexcept :
+        base_(context, base)
     { }
     template <typename Value>
     z3_resource<Value>::z3_resource(Value* const base) noexcept :
-        base_(base)
+        z3_resource(z3_context::instance(), base)
+    { }
+    template <typename Value>
+    z3_resource<Value>::z3_resource(z3_context const& context, Value* const base) noexcept :
+        base_(base),
+        context_(&context)
     { }
 
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
     template <typename... Arguments>
     z3_resource<Value, ValueBase, INC, DEC>::z3_resource(z3_invocable_output<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept :
-        base_(applicator(z3_context::instance(), std::forward<Arguments>(arguments)...))
+        z3_resource(z3_context::instance(), applicator, std::forward<Arguments>(arguments)...)
+    { }
+    template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
+    template <typename... Arguments>
+    z3_resource<Value, ValueBase, INC, DEC>::z3_resource(z3_context const& context, z3_invocable_output<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept :
+        base_(context, applicator(context, std::forward<Arguments>(arguments)...))
     { }
     template <typename Value>
     template <typename... Arguments>
     z3_resource<Value>::z3_resource(z3_invocable_output<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept :
-        base_(applicator(z3_context::instance(), std::forward<Arguments>(arguments)...))
+        z3_resource(z3_context::instance(), applicator, std::forward<Arguments>(arguments)...)
+    { }
+    template <typename Value>
+    template <typename... Arguments>
+    z3_resource<Value>::z3_resource(z3_context const& context, z3_invocable_output<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept :
+        base_(applicator(context, std::forward<Arguments>(arguments)...)),
+        context_(&context)
     { }
 
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
     z3_resource<Value, ValueBase, INC, DEC>::z3_resource(z3_resource const& other) noexcept :
-        base_(other.base_.get())
+        base_(other.context(), other.base_.get())
     { }
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
     z3_resource<Value, ValueBase, INC, DEC>& z3_resource<Value, ValueBase, INC, DEC>::operator=(z3_resource const& other) noexcept
     {
         if (&other != this)
-            base_.reset(other.base_.get());
+            base_.reset(other.context(), other.base_.get());
 
         return *this;
     }
@@ -70,29 +105,40 @@ namespace fml
         return base_;
     }
 
+    template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
+    z3_context const& z3_resource<Value, ValueBase, INC, DEC>::context() const noexcept
+    {
+        return base_.context();
+    }
+    template <typename Value>
+    z3_context const& z3_resource<Value>::context() const noexcept
+    {
+        return *context_;
+    }
+
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
     template <typename... Arguments>
-    decltype(auto) z3_resource<Value, ValueBase, INC, DEC>::apply(z3_invocable_input<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept
+    decltype(auto) z3_resource<Value, ValueBase, INC, DEC>::apply(z3_invocable_input<Value, Arguments...> auto const& applicator, Arguments&&... arguments) const noexcept
     {
-        return applicator(z3_context::instance(), base_.get(), std::forward<Arguments>(arguments)...);
+        return applicator(context(), base_.get(), std::forward<Arguments>(arguments)...);
     }
     template <typename Value>
     template <typename... Arguments>
-    decltype(auto) z3_resource<Value>::apply(z3_invocable_input<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept
+    decltype(auto) z3_resource<Value>::apply(z3_invocable_input<Value, Arguments...> auto const& applicator, Arguments&&... arguments) const noexcept
     {
-        return applicator(z3_context::instance(), base_, std::forward<Arguments>(arguments)...);
+        return applicator(context(), base_, std::forward<Arguments>(arguments)...);
     }
 
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
     template <typename... Arguments>
     void z3_resource<Value, ValueBase, INC, DEC>::update(z3_invocable_output<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept
     {
-        base_.reset(applicator(z3_context::instance(), std::forward<Arguments>(arguments)...));
+        base_.reset(context(), applicator(context(), std::forward<Arguments>(arguments)...));
     }
     template <typename Value, typename ValueBase, void INC(_Z3_context*, ValueBase*), void DEC(_Z3_context*, ValueBase*)>
     template <typename... Arguments>
     void z3_resource<Value, ValueBase, INC, DEC>::update_self(z3_invocable_input_output<Value, Arguments...> auto const& applicator, Arguments&&... arguments) noexcept
     {
-        base_.reset(applicator(z3_context::instance(), base_.get(), std::forward<Arguments>(arguments)...));
+        base_.reset(context(), applicator(context(), base_.get(), std::forward<Arguments>(arguments)...));
     }
 }
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "z3_context.hpp"
+#include "z3_symbol_table.hpp"
+
+namespace fml
+{
+    static bool is_valid_symbol(std::string const& symbol) noexcept
+    {
+        auto const contains_space_or_unprint = std::any_of(symbol.begin(), symbol.end(),
+            [](char const c)
+            {
+                return c == ' ' || std::isprint(c) == 0;
+            });
+
+        return !contains_space_or_unprint && !symbol.empty() && std::isdigit(symbol.front()) == 0;
+    }
+
+    symbol_id z3_symbol_table::intern(z3_context const& context, std::string const& name)
+    {
+        std::scoped_lock const lock(mutex_);
+
+        if (auto const entry = ids_by_name_.find(name); entry != ids_by_name_.end())
+            return entry->second;
+
+        if (!is_valid_symbol(name))
+            throw std::invalid_argument("Invalid symbol");
+
+        return insert(name, Z3_mk_string_symbol(context, name.c_str()));
+    }
+    void z3_symbol_table::intern(z3_context const& context, std::vector<_Z3_symbol*> const& symbols, std::vector<symbol_id>& ids)
+    {
+        std::scoped_lock const lock(mutex_);
+
+        for (auto* const symbol : symbols)
+        {
+            if (auto const entry = ids_by_symbol_.find(symbol); entry != ids_by_symbol_.end())
+                ids.push_back(entry->second);
+            else
+                ids.push_back(insert(Z3_get_symbol_string(context, symbol), symbol));
+        }
+    }
+
+    std::string const& z3_symbol_table::name(symbol_id const id) const
+    {
+        std::scoped_lock const lock(mutex_);
+
+        auto const index = static_cast<std::size_t>(id);
+        if (index >= names_.size())
+            throw std::invalid_argument("Invalid symbol");
+
+        return names_[index];
+    }
+    _Z3_symbol* z3_symbol_table::symbol(symbol_id const id) const
+    {
+        std::scoped_lock const lock(mutex_);
+
+        auto const index = static_cast<std::size_t>(id);
+        if (index >= symbols_.size())
+            throw std::invalid_argument("Invalid symbol");
+
+        return symbols_[index];
+    }
+
+    z3_symbol_table& z3_symbol_table::instance() noexcept
+    {
+        static z3_symbol_table table;
+
+        return table;
+    }
+
+    symbol_id z3_symbol_table::insert(std::string name, _Z3_symbol* const symbol)
+    {
+        auto const id = static_cast<symbol_id>(names_.size());
+
+        auto const& stored_name = names_.emplace_back(std::move(name));
+        symbols_.push_back(symbol);
+
+        ids_by_name_.emplace(stored_name, id);
+        ids_by_symbol_.emplace(symbol, id);
+
+        return id;
+    }
+
+    symbol_id intern_symbol(std::string const& name)
+    {
+        return z3_symbol_table::instance().intern(z3_context::instance(), name);
+    }
+    std::string const& symbol_name(symbol_id const id)
+    {
+        return z3_symbol_table::instance().name(id);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <z3.h>
+
+#include <formulae1/expression_symbol.hpp>
+
+namespace fml
+{
+    class z3_context;
+
+    // Process-wide, like the Z3 symbols themselves, which are not bound to a specific context
+    class z3_symbol_table
+    {
+        mutable std::mutex mutex_;
+
+        std::deque<std::string> names_;
+        std::vector<_Z3_symbol*> symbols_;
+
+        std::unordered_map<std::string_view, symbol_id> ids_by_name_;
+        std::unordered_map<_Z3_symbol*, symbol_id> ids_by_symbol_;
+
+    public:
+        [[nodiscard]] symbol_id intern(z3_context const&, std::string const& name);
+        // Appends the ids of symbols found in terms
+        void intern(z3_context const&, std::vector<_Z3_symbol*> const& symbols, std::vector<symbol_id>& ids);
+
+        [[nodiscard]] std::string const& name(symbol_id) const;
+        [[nodiscard]] _Z3_symbol* symbol(symbol_id) const;
+
+        [[nodiscard]] static z3_symbol_table& instance() noexcept;
+
+    private:
+        symbol_id insert(std::string name, _Z3_symbol*);
+    };
+}
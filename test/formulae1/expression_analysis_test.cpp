@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include <formulae1/expression_analysis.hpp>
+
+using namespace fml;
+
+TEST_CASE("Analysis: Bounds")
+{
+    auto const a = expression<std::uint32_t>::symbol("a");
+    auto const b = expression<std::int8_t>::symbol("b");
+
+    expression_analysis analysis;
+
+    auto const constant = analysis.bounds(7_eU32);
+    CHECK(constant.known_ones == 7);
+    CHECK(constant.known_zeros == 0xFFFFFFF8);
+    CHECK(constant.signed_minimum == 7);
+    CHECK(constant.signed_maximum == 7);
+
+    auto const symbol = analysis.bounds(a);
+    CHECK(symbol.known_zeros == 0);
+    CHECK(symbol.known_ones == 0);
+    CHECK(symbol.unsigned_maximum == 0xFFFFFFFF);
+    CHECK(symbol.signed_minimum == -0x80000000LL);
+
+    auto const masked = analysis.bounds((a & 0xF0_eU32) + 3_eU32);
+    CHECK(masked.known_zeros == 0xFFFFFF0C);
+    CHECK(masked.known_ones == 3);
+    CHECK(masked.unsigned_minimum == 3);
+    CHECK(masked.unsigned_maximum == 0xF3);
+
+    auto const shifted = analysis.bounds(a >> 28_eU32);
+    CHECK(shifted.unsigned_maximum == 15);
+    CHECK(shifted.signed_minimum == 0);
+
+    // Extended by zeros
+    auto const extended = analysis.bounds(expression<std::int32_t>(b));
+    CHECK(extended.known_zeros == 0xFFFFFF00);
+    CHECK(extended.signed_minimum == 0);
+    CHECK(extended.signed_maximum == 255);
+
+    auto const widened = analysis.bounds(expression<std::uint64_t>(expression<std::uint8_t>(a)) * 3_eU64);
+    CHECK(widened.unsigned_maximum == 765);
+
+    auto const quotient = analysis.bounds(expression<std::uint16_t>(a) / 0x100_eU16);
+    CHECK(quotient.unsigned_maximum == 0xFF);
+
+    auto const selection = analysis.bounds(expression<std::uint32_t>(a.less_than(10_eU32)) * 4_eU32);
+    CHECK(selection.known_zeros == 0xFFFFFFFB);
+    CHECK(selection.unsigned_maximum == 4);
+}
+
+TEST_CASE("Analysis: Decide")
+{
+    auto const index = expression<std::uint32_t>::symbol("index");
+
+    expression_analysis analysis;
+
+    auto const byte_index = expression<std::uint32_t>(expression<std::uint8_t>(index));
+    CHECK(analysis.decide(byte_index.less_than(256_eU32)) == true);
+    CHECK(analysis.decide(byte_index.equals(300_eU32)) == false);
+    CHECK(analysis.decide((index | 1_eU32).equals(4_eU32)) == false);
+    CHECK(analysis.decide(expression<std::int32_t>(expression<std::int8_t>(index)).less_than(-200_e32)) == false);
+    CHECK_FALSE(analysis.decide(index.less_than(256_eU32)).has_value());
+
+    // Facts about shared subterms are remembered, so that only the comparison and its constant are new
+    auto const sum = (index & 255_eU32) + (expression<std::uint32_t>::symbol("offset") & 255_eU32);
+    CHECK(analysis.decide(sum.less_than(511_eU32)) == true);
+    auto const facts = analysis.size();
+    CHECK(analysis.decide(sum.less_than(600_eU32)) == true);
+    CHECK(analysis.size() <= facts + 3);
+    CHECK(analysis.decide(expression<bool>(true)) == true);
+
+    expression_context const context;
+    CHECK_THROWS_AS(analysis.decide(expression<std::uint32_t>::symbol(context, "index").less_than(expression<std::uint32_t>(context, 1))), std::logic_error);
+}
+
+TEST_CASE("Analysis: Deep term")
+{
+    expression_context context;
+    context.select_simplification_mode(simplification_mode::lazy);
+
+    auto const a = expression<std::uint32_t>::symbol(context, "a");
+    auto const b = expression<std::uint32_t>::symbol(context, "b");
+
+    // Too deep for a recursive analysis
+    auto value = a;
+    for (auto index = 0; index < 20000; ++index)
+        value = ((value ^ b) & expression<std::uint32_t>(context, 255)) + b;
+
+    // Both at most 255
+    auto const sum = (value & expression<std::uint32_t>(context, 255)) + ((value ^ b) & expression<std::uint32_t>(context, 255));
+
+    expression_analysis analysis;
+    CHECK(analysis.bounds(sum).unsigned_maximum == 510);
+    CHECK(analysis.decide(sum.less_than(expression<std::uint32_t>(context, 511))) == true);
+    CHECK_FALSE(analysis.decide(sum.equals(expression<std::uint32_t>(context, 5))).has_value());
+}
@@ -0,0 +1,143 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <formulae1/expression_context.hpp>
+#include <formulae1/expression_solver.hpp>
+
+using namespace fml;
+
+TEST_CASE("Context: Per-thread mode")
+{
+    auto const value = expression<unsigned>::symbol("X") + expression<unsigned>(1);
+    auto const condition = value.equals(expression<unsigned>(2));
+
+    select_context_mode(context_mode::per_thread);
+    REQUIRE(selected_context_mode() == context_mode::per_thread);
+
+    SECTION("Isolation")
+    {
+        expression_solver const solver;
+
+        CHECK_THROWS_WITH(solver.check(condition), "Invalid context");
+        CHECK(solver.check(translate(condition)).has_value());
+    }
+    SECTION("Translation")
+    {
+        std::mutex value_mutex;
+
+        std::vector<unsigned> results(4);
+        std::vector<std::thread> workers;
+        for (std::size_t index = 0; index < results.size(); ++index)
+        {
+            workers.emplace_back(
+                [&value, &value_mutex, &result = results.at(index), index]
+                {
+                    auto local_value = [&value, &value_mutex]
+                    {
+                        // Source context must not be accessed concurrently
+                        std::scoped_lock const lock(value_mutex);
+
+                        return translate(value);
+                    }();
+                    local_value.substitute("X", expression<unsigned>(static_cast<unsigned>(index)));
+
+                    result = local_value.evaluate();
+                });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        for (std::size_t index = 0; index < results.size(); ++index)
+            CHECK(results.at(index) == index + 1);
+    }
+
+    select_context_mode(context_mode::shared);
+}
+
+TEST_CASE("Context: Explicit contexts")
+{
+    expression_context context_1;
+    expression_context context_2;
+
+    auto const value_1 = expression<unsigned>::symbol(context_1, "X") + expression<unsigned>(context_1, 3);
+    auto const value_2 = expression<unsigned>::symbol(context_2, "X") + expression<unsigned>(context_2, 3);
+
+    CHECK(value_1.representation() == value_2.representation());
+
+    SECTION("Translation")
+    {
+        CHECK(translate(value_1, context_2) == value_2);
+        CHECK(translate(translate(value_2, context_1), context_2) == value_2);
+    }
+    SECTION("Solver")
+    {
+        expression_solver const solver_1(context_1);
+
+        auto const condition_1 = value_1.equals(expression<unsigned>(context_1, 5));
+        auto const condition_2 = parse_expression<bool>(context_2, "(declare-fun X () (_ BitVec 32)) (assert (= X #x00000002))");
+
+        auto const model = solver_1.check(condition_1);
+        REQUIRE(model.has_value());
+        CHECK(model->apply(expression<unsigned>::symbol(context_1, "X")).evaluate() == 2);
+
+        CHECK_THROWS_WITH(solver_1.check(condition_2), "Invalid context");
+        CHECK(solver_1.check(translate(condition_2, context_1) & condition_1).has_value());
+    }
+}
+
+TEST_CASE("Context: Lazy simplification")
+{
+    expression_context context;
+    context.select_simplification_mode(simplification_mode::lazy);
+    REQUIRE(context.selected_simplification_mode() == simplification_mode::lazy);
+
+    auto const a = expression<unsigned>::symbol(context, "a");
+
+    auto value = a;
+    for (auto index = 0; index < 8; ++index)
+        value += expression<unsigned>(context, 1);
+
+    CHECK(value == a + expression<unsigned>(context, 8));
+    CHECK(value.representation() == (a + expression<unsigned>(context, 8)).representation());
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"a"});
+
+    value -= a;
+    CHECK(value.conclusive());
+    CHECK(value.evaluate() == 8);
+
+    expression_solver const solver(context);
+    CHECK(solver.check(value.equals(a * expression<unsigned>(context, 2))).has_value());
+    CHECK_FALSE(solver.check(value.equals(expression<unsigned>(context, 7))).has_value());
+}
+
+TEST_CASE("Context: Dependency cache")
+{
+    expression_context context;
+    context.select_dependency_cache_capacity(2);
+    REQUIRE(context.selected_dependency_cache_capacity() == 2);
+
+    auto const a = expression<unsigned>::symbol(context, "a");
+    auto const b = expression<unsigned>::symbol(context, "b");
+    auto const c = expression<unsigned>::symbol(context, "c");
+
+    auto value = a * b;
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"a", "b"});
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"a", "b"});
+
+    value += c;
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"a", "b", "c"});
+
+    value.substitute("a", expression<unsigned>(context, 0));
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"c"});
+
+    // Exceeds the capacity
+    CHECK((a + b + c).dependencies() == std::unordered_set<std::string>{"a", "b", "c"});
+    CHECK((a ^ c).dependencies() == std::unordered_set<std::string>{"a", "c"});
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"c"});
+
+    context.select_dependency_cache_capacity(0);
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"c"});
+}
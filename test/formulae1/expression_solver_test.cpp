@@ -0,0 +1,610 @@
+#include <limits>
+
+#include <catch2/catch.hpp>
+
+#include <formulae1/expression_solver.hpp>
+
+using namespace fml;
+
+TEST_CASE("Solver: Incremental")
+{
+    auto const x = expression<unsigned>::symbol("x");
+
+    expression_solver solver;
+    solver.add(expression<unsigned>(10).less_than(x));
+    REQUIRE(solver.check().has_value());
+
+    SECTION("Scopes")
+    {
+        solver.push();
+        solver.add(x.less_than(expression<unsigned>(12)));
+
+        auto const model = solver.check();
+        REQUIRE(model.has_value());
+        CHECK(model->apply(x).evaluate() == 11);
+
+        // Copies keep the assertions of all scopes, but not the scopes themselves
+        auto copy = solver;
+        CHECK(copy.check(x.equals(expression<unsigned>(11))).has_value());
+        CHECK_FALSE(copy.check(x.equals(expression<unsigned>(12))).has_value());
+        CHECK_THROWS_WITH(copy.pop(), "Invalid scope");
+
+        expression_solver assigned;
+        assigned.add(x.equals(expression<unsigned>(12)));
+        assigned = solver;
+        CHECK(assigned.check(x.equals(expression<unsigned>(11))).has_value());
+
+        solver.push();
+        solver.add(x.equals(expression<unsigned>(12)));
+        CHECK_FALSE(solver.check().has_value());
+
+        solver.pop(0);
+        CHECK_FALSE(solver.check().has_value());
+
+        solver.pop(2);
+        CHECK(solver.check().has_value());
+        CHECK_THROWS_WITH(solver.pop(), "Invalid scope");
+    }
+    SECTION("Assumptions")
+    {
+        CHECK_FALSE(solver.check(x.equals(expression<unsigned>(5))).has_value());
+        CHECK(solver.check({x.less_than(expression<unsigned>(20)), expression<unsigned>(15).less_than(x)}).has_value());
+        CHECK_FALSE(solver.check({x.less_than(expression<unsigned>(20)), expression<unsigned>(25).less_than(x)}).has_value());
+
+        // Assumptions do not persist
+        CHECK(solver.check().has_value());
+    }
+    SECTION("Copy")
+    {
+        auto copy = solver;
+        copy.add(x.less_than(expression<unsigned>(10)));
+
+        CHECK_FALSE(copy.check().has_value());
+        CHECK(solver.check().has_value());
+    }
+}
+
+TEST_CASE("Solver: Prefix sharing")
+{
+    auto const x = expression<unsigned>::symbol("x");
+    auto const y = expression<unsigned>::symbol("y");
+
+    expression_solver solver;
+    solver.select_query_mode(query_mode::prefix_sharing);
+    REQUIRE(solver.selected_query_mode() == query_mode::prefix_sharing);
+
+    auto const path = x.less_than(y) & y.less_than(expression<unsigned>(10));
+
+    CHECK(solver.check(path).has_value());
+    CHECK(solver.check(path & x.equals(expression<unsigned>(8))).has_value());
+    CHECK_FALSE(solver.check(path & x.equals(expression<unsigned>(9))).has_value());
+    CHECK(solver.check(path & expression<unsigned>(5).less_than(x)).has_value());
+
+    // Shorter and unrelated formulas
+    CHECK(solver.check(x.less_than(y)).has_value());
+    CHECK(solver.check(x.equals(expression<unsigned>(9))).has_value());
+
+    // Previous formulas are not kept as assertions
+    solver.add(y.equals(expression<unsigned>(3)));
+    CHECK_FALSE(solver.check(path & x.equals(expression<unsigned>(8))).has_value());
+    CHECK(solver.check(path & x.equals(expression<unsigned>(2))).has_value());
+
+    auto const copy = solver;
+    CHECK(copy.check(x.equals(expression<unsigned>(7))).has_value());
+    CHECK_FALSE(copy.check(y.equals(expression<unsigned>(7))).has_value());
+
+    // The original keeps its prefix
+    CHECK(solver.check(path & x.equals(expression<unsigned>(2))).has_value());
+    CHECK_FALSE(solver.check(path & x.equals(expression<unsigned>(3))).has_value());
+}
+
+TEST_CASE("Solver: Result cache")
+{
+    auto const x = expression<unsigned>::symbol("x");
+
+    expression_solver solver;
+    solver.select_cache_capacity(2);
+    REQUIRE(solver.selected_cache_capacity() == 2);
+
+    auto const formula_1 = x.less_than(expression<unsigned>(5));
+    auto const formula_2 = x.equals(expression<unsigned>(7));
+    auto const formula_3 = expression<unsigned>(9).less_than(x);
+
+    auto const model = solver.check(formula_2);
+    REQUIRE(model.has_value());
+    CHECK(solver.check(formula_1).has_value());
+    CHECK(solver.cache_misses() == 2);
+
+    // Structurally equal formulas hit
+    auto const cached_model = solver.check(x.equals(expression<unsigned>(7)));
+    REQUIRE(cached_model.has_value());
+    CHECK(cached_model->apply(x).evaluate() == 7);
+    CHECK(solver.cache_hits() == 1);
+
+    // Evicts the least recently used (formula_1)
+    CHECK(solver.check(formula_3).has_value());
+    CHECK(solver.check(formula_2).has_value());
+    CHECK(solver.cache_hits() == 2);
+    CHECK(solver.check(formula_1).has_value());
+    CHECK(solver.cache_misses() == 4);
+
+    // Assertions invalidate
+    solver.add(x.less_than(expression<unsigned>(6)));
+    CHECK_FALSE(solver.check(formula_2).has_value());
+    CHECK_FALSE(solver.check(formula_2).has_value());
+    CHECK(solver.cache_misses() == 5);
+    CHECK(solver.cache_hits() == 3);
+}
+
+TEST_CASE("Solver: Counterexample cache")
+{
+    auto const x = expression<unsigned>::symbol("x");
+    auto const y = expression<unsigned>::symbol("y");
+
+    expression_solver solver;
+    solver.select_counterexample_capacity(4);
+    REQUIRE(solver.selected_counterexample_capacity() == 4);
+
+    auto const model = solver.check(x.equals(expression<unsigned>(3)) & y.equals(expression<unsigned>(4)));
+    REQUIRE(model.has_value());
+    CHECK(solver.counterexample_hits() == 0);
+
+    // Satisfied by the previous model
+    auto const recalled_model = solver.check(x.less_than(y));
+    REQUIRE(recalled_model.has_value());
+    CHECK(recalled_model->apply(x).evaluate() == 3);
+    CHECK(solver.counterexample_hits() == 1);
+
+    // Supersets of unsatisfiable sets
+    auto const contradiction = x.less_than(expression<unsigned>(2)) & expression<unsigned>(5).less_than(x);
+    CHECK_FALSE(solver.check(contradiction).has_value());
+    CHECK(solver.counterexample_hits() == 1);
+    CHECK_FALSE(solver.check({contradiction, y.equals(expression<unsigned>(1))}).has_value());
+    CHECK(solver.counterexample_hits() == 2);
+
+    // Models are discarded with new assertions
+    solver.add(x.equals(expression<unsigned>(1)));
+    auto const new_model = solver.check(x.less_than(expression<unsigned>(4)));
+    REQUIRE(new_model.has_value());
+    CHECK(new_model->apply(x).evaluate() == 1);
+    CHECK(solver.counterexample_hits() == 2);
+}
+
+TEST_CASE("Solver: Independence slicing")
+{
+    auto const x = expression<unsigned>::symbol("x");
+    auto const y = expression<unsigned>::symbol("y");
+    auto const z = expression<unsigned>::symbol("z");
+
+    expression_solver solver;
+    solver.select_slicing_mode(slicing_mode::independence);
+    REQUIRE(solver.selected_slicing_mode() == slicing_mode::independence);
+    solver.select_cache_capacity(8);
+
+    auto const constraint_x = x.less_than(expression<unsigned>(5)) & expression<unsigned>(3).less_than(x);
+    auto const constraint_y = y.equals(expression<unsigned>(7));
+
+    auto const model = solver.check(constraint_x & constraint_y);
+    REQUIRE(model.has_value());
+    CHECK(model->apply(x).evaluate() == 4);
+    CHECK(model->apply(y).evaluate() == 7);
+    CHECK(solver.cache_misses() == 2);
+
+    // Only the group of the new constraint is solved again
+    auto const next_model = solver.check(constraint_x & constraint_y & z.equals(y));
+    REQUIRE(next_model.has_value());
+    CHECK(next_model->apply(x).evaluate() == 4);
+    CHECK(next_model->apply(z).evaluate() == 7);
+    CHECK(solver.cache_hits() == 1);
+
+    CHECK_FALSE(solver.check(constraint_x & constraint_y & y.equals(expression<unsigned>(8))).has_value());
+
+    SECTION("Assertions")
+    {
+        // Groups related to the assertions keep their values consistent with them
+        solver.add(x.less_than(z));
+        auto const asserted_model = solver.check(x.equals(expression<unsigned>(1)) & constraint_y & expression<unsigned>(1).less_than(z));
+        REQUIRE(asserted_model.has_value());
+        CHECK(asserted_model->apply(x).evaluate() == 1);
+        CHECK(asserted_model->apply(y).evaluate() == 7);
+        CHECK(asserted_model->apply(x.less_than(z)).evaluate() == true);
+
+        solver.push();
+        solver.add(z.equals(expression<unsigned>(1)));
+        CHECK_FALSE(solver.check(x.equals(expression<unsigned>(1)) & constraint_y).has_value());
+        solver.pop();
+        CHECK(solver.check(x.equals(expression<unsigned>(1)) & constraint_y).has_value());
+    }
+    SECTION("Memory")
+    {
+        // Memory reads may alias, even without shared symbols
+        auto const p = expression<unsigned>::symbol("p");
+        auto const q = expression<unsigned>::symbol("q");
+        auto const memory_model = solver.check(
+            p.dereference<unsigned char>().equals(expression<unsigned char>(1)) &
+            q.dereference<unsigned char>().equals(expression<unsigned char>(2)) &
+            p.equals(q));
+        CHECK_FALSE(memory_model.has_value());
+    }
+}
+
+TEST_CASE("Solver: Limits")
+{
+    auto const a = expression<unsigned long long>::symbol("a");
+    auto const b = expression<unsigned long long>::symbol("b");
+
+    // Factorization of a prime, too hard to refute within the limits
+    auto const one = expression<unsigned long long>(1);
+    auto const bound = expression<unsigned long long>(1ULL << 32U);
+    auto const factorization = (a * b).equals(expression<unsigned long long>(9223372036854775783ULL)) &
+        one.less_than(a) & a.less_than(bound) &
+        one.less_than(b) & b.less_than(bound);
+
+    expression_solver solver;
+    solver.select_limits({.timeout = std::chrono::milliseconds(50), .resource_limit = 0});
+    REQUIRE(solver.selected_limits().timeout == std::chrono::milliseconds(50));
+
+    CHECK(solver.solve(factorization).status == satisfiability::unknown);
+    CHECK_THROWS_WITH(solver.check(factorization), "Invalid expression");
+
+    // Per call
+    auto const bounded_result = solver.solve(factorization, {.timeout = std::chrono::milliseconds(0), .resource_limit = 10000});
+    CHECK(bounded_result.status == satisfiability::unknown);
+    CHECK_FALSE(bounded_result.model.has_value());
+
+    auto const result = solver.solve(a.equals(expression<unsigned long long>(6)));
+    CHECK(result.status == satisfiability::satisfiable);
+    REQUIRE(result.model.has_value());
+    CHECK(result.model->apply(a).evaluate() == 6);
+    CHECK(solver.solve({a.less_than(one), b.equals(a)}).status == satisfiability::satisfiable);
+    CHECK(solver.solve({a.less_than(one), one.less_than(a)}).status == satisfiability::unsatisfiable);
+
+    // Unknown results are not cached
+    solver.select_cache_capacity(4);
+    CHECK(solver.solve(factorization).status == satisfiability::unknown);
+    CHECK(solver.solve(factorization).status == satisfiability::unknown);
+    CHECK(solver.cache_hits() == 0);
+}
+
+TEST_CASE("Solver: Asynchronous")
+{
+    auto const a = expression<unsigned long long>::symbol("a");
+    auto const b = expression<unsigned long long>::symbol("b");
+
+    expression_solver solver;
+    solver.add(a.less_than(b));
+
+    auto task = solver.solve_async(b.equals(expression<unsigned long long>(1)));
+
+    // The solver remains usable meanwhile
+    CHECK_FALSE(solver.check(b.equals(expression<unsigned long long>(0))).has_value());
+
+    auto const result = task.get();
+    CHECK(result.status == satisfiability::satisfiable);
+    REQUIRE(result.model.has_value());
+    CHECK(result.model->apply(a).evaluate() == 0);
+    CHECK(task.ready());
+    CHECK_THROWS_WITH(task.get(), "Invalid task");
+
+    SECTION("Cancellation")
+    {
+        auto const one = expression<unsigned long long>(1);
+        auto const bound = expression<unsigned long long>(1ULL << 32U);
+        auto hard_task = solver.solve_async(
+            {
+                (a * b).equals(expression<unsigned long long>(9223372036854775783ULL)),
+                one.less_than(a), a.less_than(bound),
+                one.less_than(b), b.less_than(bound)
+            });
+
+        hard_task.cancel();
+        CHECK(hard_task.ready());
+        CHECK(hard_task.get().status == satisfiability::unknown);
+    }
+    SECTION("Scopes")
+    {
+        solver.push();
+        solver.add(expression<unsigned long long>(5).less_than(a));
+
+        auto scoped_task = solver.solve_async(b.equals(expression<unsigned long long>(6)));
+        CHECK(scoped_task.get().status == satisfiability::unsatisfiable);
+
+        solver.pop();
+        CHECK(solver.solve_async(b.equals(expression<unsigned long long>(6))).get().status == satisfiability::satisfiable);
+    }
+}
+
+TEST_CASE("Solver: Batch")
+{
+    auto const x = expression<unsigned>::symbol("x");
+
+    expression_solver solver;
+    solver.add(x.less_than(expression<unsigned>(40)));
+
+    std::vector<expression<bool>> formulas;
+    for (auto value = 0U; value < 100U; ++value)
+        formulas.push_back(x.equals(expression<unsigned>(value)));
+
+    auto const worker_count = GENERATE(0U, 1U, 4U);
+
+    auto const results = solver.solve_batch(formulas, worker_count);
+    REQUIRE(results.size() == formulas.size());
+    for (auto value = 0U; value < 100U; ++value)
+    {
+        auto const& result = results[value];
+        if (value < 40U)
+        {
+            CHECK(result.status == satisfiability::satisfiable);
+            REQUIRE(result.model.has_value());
+            CHECK(result.model->apply(x).evaluate() == value);
+        }
+        else
+        {
+            CHECK(result.status == satisfiability::unsatisfiable);
+        }
+    }
+
+    CHECK(solver.solve_batch({}).empty());
+
+    // Within a scope
+    solver.push();
+    solver.add(expression<unsigned>(20).less_than(x));
+
+    auto const scoped_results = solver.solve_batch(formulas, worker_count);
+    REQUIRE(scoped_results.size() == formulas.size());
+    for (auto value = 0U; value < 100U; ++value)
+        CHECK((scoped_results[value].status == satisfiability::satisfiable) == (value > 20U && value < 40U));
+
+    solver.pop();
+    CHECK(solver.solve_batch(formulas, worker_count)[10].status == satisfiability::satisfiable);
+}
+
+TEST_CASE("Solver: Portfolio")
+{
+    auto const x = expression<unsigned>::symbol("x");
+    auto const y = expression<unsigned>::symbol("y");
+
+    expression_solver solver;
+    solver.select_portfolio(
+        {
+            {.strategy = solver_strategy::simple, .random_seed = 0},
+            {.strategy = solver_strategy::simple, .random_seed = 1},
+            {.strategy = solver_strategy::general, .random_seed = 0},
+            {.strategy = solver_strategy::bit_blast, .random_seed = 0}
+        });
+    REQUIRE(solver.selected_portfolio().size() == 4);
+
+    solver.add(x.less_than(y));
+    solver.push();
+    solver.add(y.less_than(expression<unsigned>(5)));
+
+    auto const model = solver.check(expression<unsigned>(2).less_than(x));
+    REQUIRE(model.has_value());
+    CHECK(model->apply(x).evaluate() == 3);
+    CHECK(model->apply(y).evaluate() == 4);
+    CHECK_FALSE(solver.check(x.equals(expression<unsigned>(5))).has_value());
+
+    solver.pop();
+    CHECK(solver.check(x.equals(expression<unsigned>(5))).has_value());
+
+    SECTION("Prefix sharing")
+    {
+        solver.select_query_mode(query_mode::prefix_sharing);
+        auto const path = y.less_than(expression<unsigned>(3));
+        CHECK(solver.check(path).has_value());
+        CHECK_FALSE(solver.check(path & x.equals(expression<unsigned>(2))).has_value());
+    }
+    SECTION("Limits")
+    {
+        auto const a = expression<unsigned long long>::symbol("a");
+        auto const b = expression<unsigned long long>::symbol("b");
+        auto const one = expression<unsigned long long>(1);
+        auto const bound = expression<unsigned long long>(1ULL << 32U);
+
+        auto const result = solver.solve(
+            {
+                (a * b).equals(expression<unsigned long long>(9223372036854775783ULL)),
+                one.less_than(a), a.less_than(bound),
+                one.less_than(b), b.less_than(bound)
+            },
+            {.timeout = std::chrono::milliseconds(50), .resource_limit = 0});
+        CHECK(result.status == satisfiability::unknown);
+    }
+}
+
+TEST_CASE("Solver: Cube and conquer")
+{
+    auto const x = expression<unsigned>::symbol("x");
+    auto const y = expression<unsigned>::symbol("y");
+
+    auto const one = expression<unsigned>(1);
+    auto const bound = expression<unsigned>(1U << 8U);
+    auto const factorization = [&](unsigned const product)
+    {
+        return (x * y).equals(expression<unsigned>(product)) &
+            one.less_than(x) & x.less_than(bound) & x.less_than(y) &
+            one.less_than(y) & y.less_than(bound);
+    };
+
+    expression_solver solver;
+    solver.select_split_depth(100);
+    CHECK(solver.selected_split_depth() == expression_solver::max_split_depth);
+
+    solver.select_split_depth(GENERATE(1U, 4U));
+
+    auto const model = solver.check(factorization(143));
+    REQUIRE(model.has_value());
+    CHECK(model->apply(x).evaluate() == 11);
+    CHECK(model->apply(y).evaluate() == 13);
+
+    CHECK_FALSE(solver.check(factorization(251)).has_value());
+
+    solver.add(x.equals(expression<unsigned>(3)));
+    CHECK_FALSE(solver.check(factorization(143)).has_value());
+    CHECK(solver.check(factorization(3 * 7)).has_value());
+
+    // Nothing to split on
+    auto const z = expression<bool>::symbol("z");
+    CHECK(solver.check(z).has_value());
+}
+
+TEST_CASE("Solver: Satisfiability")
+{
+    auto const x = expression<unsigned>::symbol("x");
+    auto const y = expression<unsigned>::symbol("y");
+
+    expression_solver solver;
+    solver.select_cache_capacity(4);
+    solver.select_counterexample_capacity(4);
+    solver.add(x.less_than(y));
+
+    auto const path = y.less_than(expression<unsigned>(2));
+    CHECK(solver.check_satisfiability() == satisfiability::satisfiable);
+    CHECK(solver.check_satisfiability(path) == satisfiability::satisfiable);
+    CHECK(solver.check_satisfiability(path & x.equals(expression<unsigned>(1))) == satisfiability::unsatisfiable);
+
+    // Models are not cached without being built
+    auto const model = solver.check(path);
+    REQUIRE(model.has_value());
+    CHECK(model->apply(x).evaluate() == 0);
+    CHECK(model->apply(y).evaluate() == 1);
+
+    SECTION("Slicing")
+    {
+        auto const z = expression<unsigned>::symbol("z");
+        solver.select_slicing_mode(slicing_mode::independence);
+        CHECK(solver.check_satisfiability({path, z.equals(expression<unsigned>(3))}) == satisfiability::satisfiable);
+        CHECK(solver.check({path, z.equals(expression<unsigned>(3))}).has_value());
+    }
+    SECTION("Failure")
+    {
+        expression_context const other_context;
+        auto const other_x = expression<unsigned>::symbol(other_context, "x");
+        CHECK_THROWS_WITH(solver.check_satisfiability(other_x.equals(expression<unsigned>(other_context, 0))), "Invalid context");
+
+        // Models are still built afterwards
+        CHECK(solver.check(y.equals(expression<unsigned>(6))).has_value());
+    }
+    SECTION("Disabled")
+    {
+        solver.select_model_generation(false);
+        REQUIRE_FALSE(solver.selected_model_generation());
+
+        auto const result = solver.solve(y.equals(expression<unsigned>(5)));
+        CHECK(result.status == satisfiability::satisfiable);
+        CHECK_FALSE(result.model.has_value());
+        CHECK_THROWS_AS(solver.check(y.equals(expression<unsigned>(6))), std::logic_error);
+        CHECK_FALSE(solver.check(y.equals(expression<unsigned>(0))).has_value());
+
+        solver.select_model_generation(true);
+        CHECK(solver.check(y.equals(expression<unsigned>(5))).has_value());
+    }
+}
+
+TEST_CASE("Solver: Trivial")
+{
+    auto const x = expression<unsigned>::symbol("x");
+
+    expression_solver solver;
+    auto const model = solver.check(expression<bool>(true));
+    REQUIRE(model.has_value());
+    CHECK_FALSE(model->apply(x).conclusive());
+    CHECK(solver.check().has_value());
+    CHECK_FALSE(solver.check(expression<bool>(false)).has_value());
+    CHECK_FALSE(solver.check({x.equals(x + expression<unsigned>(1)), x.equals(expression<unsigned>(1))}).has_value());
+    CHECK(solver.trivial_hits() == 4);
+
+    std::vector const formulas{expression<bool>(true), x.equals(expression<unsigned>(2)), x.less_than(expression<unsigned>(0))};
+    auto const results = solver.solve_batch(formulas, 2);
+    CHECK(results[0].status == satisfiability::satisfiable);
+    CHECK(results[1].status == satisfiability::satisfiable);
+    CHECK(results[2].status == satisfiability::unsatisfiable);
+    CHECK(solver.trivial_hits() == 6);
+
+    // Assertions have to be checked nonetheless
+    solver.add(x.less_than(expression<unsigned>(3)));
+    solver.add(expression<unsigned>(2).less_than(x));
+    CHECK_FALSE(solver.check(expression<bool>(true)).has_value());
+    CHECK(solver.check_satisfiability(expression<bool>(false)) == satisfiability::unsatisfiable);
+    CHECK(solver.trivial_hits() == 7);
+
+    // Decided by the bounds of the operands
+    auto const byte_x = expression<unsigned>(expression<unsigned char>(x));
+    CHECK_FALSE(solver.check(expression<unsigned>(255).less_than(byte_x)).has_value());
+    CHECK(solver.trivial_hits() == 8);
+
+    expression_solver unconstrained;
+    CHECK(unconstrained.check(byte_x.less_than(expression<unsigned>(256))).has_value());
+    CHECK(unconstrained.trivial_hits() == 1);
+
+    SECTION("Shared subterms")
+    {
+        auto const y = expression<unsigned>::symbol("y");
+
+        // Both at most 255
+        auto const sum = (x & expression<unsigned>(255)) + (y & expression<unsigned>(255));
+        CHECK(unconstrained.check(sum.less_than(expression<unsigned>(511))).has_value());
+
+        auto const facts = unconstrained.analyzed_facts();
+        CHECK(facts > 6);
+
+        // Facts about the sum and its operands are remembered, so that only the comparison and its constant are new
+        CHECK(unconstrained.check(sum.less_than(expression<unsigned>(511))).has_value());
+        CHECK(unconstrained.analyzed_facts() == facts);
+        CHECK(unconstrained.check_satisfiability(sum.less_than(expression<unsigned>(600))) == satisfiability::satisfiable);
+        CHECK(unconstrained.analyzed_facts() <= facts + 3);
+        CHECK(unconstrained.trivial_hits() == 4);
+
+        // But not by copies
+        auto const copy = unconstrained;
+        CHECK(copy.analyzed_facts() == 0);
+    }
+    SECTION("Deep term")
+    {
+        expression_context context;
+        context.select_simplification_mode(simplification_mode::lazy);
+
+        auto const a = expression<unsigned>::symbol(context, "a");
+        auto const b = expression<unsigned>::symbol(context, "b");
+
+        // Too deep for a recursive analysis
+        auto value = a;
+        for (auto index = 0; index < 20000; ++index)
+            value = ((value ^ b) & expression<unsigned>(context, 255)) + b;
+
+        // Both at most 255
+        auto const sum = (value & expression<unsigned>(context, 255)) + ((value ^ b) & expression<unsigned>(context, 255));
+
+        expression_solver const deep_solver(context);
+        CHECK(deep_solver.check(sum.less_than(expression<unsigned>(context, 511))).has_value());
+        CHECK(deep_solver.check_satisfiability(expression<unsigned>(context, 510).less_than(sum)) == satisfiability::unsatisfiable);
+        CHECK(deep_solver.trivial_hits() == 2);
+    }
+}
+
+TEST_CASE("Solver: Range")
+{
+    auto const x = expression<unsigned>::symbol("x");
+    auto const y = expression<int>::symbol("y");
+
+    expression_solver solver;
+    solver.add(x.less_than(expression<unsigned>(1000)));
+
+    CHECK(solver.range(x) == std::pair(0U, 999U));
+    CHECK(solver.range(x * expression<unsigned>(4) + expression<unsigned>(1), expression<unsigned>(10).less_than(x)) == std::pair(45U, 3997U));
+    CHECK(solver.range(expression<unsigned char>(x), x.less_than(expression<unsigned>(300)) & expression<unsigned>(250).less_than(x)) == std::pair<unsigned char, unsigned char>(0, 255));
+    CHECK_FALSE(solver.range(x, expression<unsigned>(2000).less_than(x)).has_value());
+    CHECK(solver.range(expression<unsigned>(7), x.equals(expression<unsigned>(3))) == std::pair(7U, 7U));
+
+    // Ordered by sign
+    CHECK(solver.range(y) == std::pair(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+    CHECK(solver.range(y, y.less_than(expression<int>(5)) & expression<int>(-20).less_than(y)) == std::pair(-19, 4));
+    CHECK(solver.range(y * y, y.less_than(expression<int>(3)) & expression<int>(-5).less_than(y)) == std::pair(0, 16));
+
+    SECTION("Without models")
+    {
+        solver.select_model_generation(false);
+        CHECK(solver.range(x, expression<unsigned>(10).less_than(x) & x.less_than(expression<unsigned>(20))) == std::pair(11U, 19U));
+        CHECK(solver.range(y, y.less_than(expression<int>(-7))) == std::pair(std::numeric_limits<int>::min(), -8));
+    }
+}
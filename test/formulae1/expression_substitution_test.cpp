@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+
+#include <formulae1/expression_substitution.hpp>
+
+using namespace fml;
+
+TEST_CASE("Substitution: Shared mapping")
+{
+    auto const a = expression<unsigned>::symbol("a");
+    auto const b = expression<unsigned>::symbol("b");
+    auto const c = expression<unsigned>::symbol("c");
+
+    expression_substitution substitution({{"a", expression<>(expression<unsigned>(3))}, {"b", expression<>(c + c)}});
+
+    auto const shared = a * b;
+
+    auto const value_1 = shared + c;
+    auto const value_2 = shared - c;
+    auto const value_3 = c * c;
+
+    for (auto const& value : {value_1, value_2, value_3})
+    {
+        auto expected = value;
+        expected.substitute({{"a", expression<>(expression<unsigned>(3))}, {"b", expression<>(c + c)}});
+
+        CHECK(substitution.apply(value) == expected);
+    }
+
+    CHECK(substitution.apply(expression<bool>::symbol("a")) == expression<bool>::symbol("a"));
+    CHECK(substitution.apply(a.less_than(b)) == expression<unsigned>(3).less_than(c + c));
+}
+
+TEST_CASE("Substitution: Deep term")
+{
+    expression_context context;
+    context.select_simplification_mode(simplification_mode::lazy);
+
+    auto const a = expression<unsigned>::symbol(context, "a");
+    auto const b = expression<unsigned>::symbol(context, "b");
+
+    // Too deep for a recursive rewrite
+    auto value = a;
+    for (auto index = 0; index < 100000; ++index)
+        value = (value ^ b) - b;
+
+    expression_substitution substitution({{"b", expression<>(expression<unsigned>::symbol(context, "c"))}});
+    CHECK(substitution.apply(value).dependencies() == std::unordered_set<std::string>{"a", "c"});
+}
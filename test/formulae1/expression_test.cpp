@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 
 #include <catch2/catch.hpp>
@@ -12,6 +13,11 @@ static_assert(std::is_same_v<decltype(expression(static_cast<unsigned short>(0))
 static_assert(std::is_same_v<decltype(expression(static_cast<unsigned int>(0))), expression<unsigned int>>);
 static_assert(std::is_same_v<decltype(expression(static_cast<signed int>(0))), expression<signed int>>);
 
+// Handle semantics
+static_assert(std::is_nothrow_move_constructible_v<expression<unsigned int>>);
+static_assert(std::is_nothrow_move_assignable_v<expression<unsigned int>>);
+static_assert(!std::has_virtual_destructor_v<expression<unsigned int>>);
+
 TEST_CASE("Expression: Symbol requirements")
 {
     std::string const error_message("Invalid symbol");
@@ -26,6 +32,27 @@ TEST_CASE("Expression: Symbol requirements")
     CHECK_THROWS_WITH(expression<unsigned char>::symbol("\n"), error_message);
 }
 
+TEST_CASE("Expression: Symbol ids")
+{
+    auto const id_a = intern_symbol("a");
+    auto const id_b = intern_symbol("b");
+
+    CHECK(intern_symbol("a") == id_a);
+    CHECK(id_a != id_b);
+    CHECK(symbol_name(id_b) == "b");
+    CHECK_THROWS_WITH(intern_symbol("0"), "Invalid symbol");
+
+    auto const a = expression<unsigned>::symbol(id_a);
+    CHECK(a == expression<unsigned>::symbol("a"));
+
+    auto const value = (a + expression<unsigned>::symbol("b")) * a;
+
+    std::vector<symbol_id> expected{id_a, id_b};
+    std::sort(expected.begin(), expected.end());
+    CHECK(value.dependency_ids() == expected);
+    CHECK(parse_expression<bool>("(declare-const c (_ BitVec 32)) (assert (bvult c #x00000001))").dependency_ids() == std::vector{intern_symbol("c")});
+}
+
 TEST_CASE("Expression: Signedness")
 {
     SECTION("Unsigned to signed")
@@ -175,6 +202,19 @@ TEST_CASE("Expression: Dependencies")
         ((value_2_symbol == *value_7_dependencies.begin() && value_6_symbol == *std::next(value_7_dependencies.begin()))
             || (value_6_symbol == *value_7_dependencies.begin() && value_2_symbol == *std::next(value_7_dependencies.begin()))));
 }
+TEST_CASE("Expression: Dependencies (shared)")
+{
+    auto const y = expression<unsigned>::symbol("y");
+
+    // Subterms are shared, the tree grows exponentially
+    auto value = expression<unsigned>::symbol("x");
+    for (auto iteration = 0; iteration < 64; ++iteration)
+        value = value * (value ^ y);
+
+    CHECK(value.dependencies() == std::unordered_set<std::string>{"x", "y"});
+    CHECK(value.dependencies_indirect().empty());
+}
+
 TEST_CASE("Expression: Dependencies (indirect)")
 {
     expression<unsigned char> const value_1(27);
@@ -204,6 +244,41 @@ TEST_CASE("Expression: Dependencies (indirect)")
     REQUIRE(expression<>(value_1) == *value_6_dependencies.begin());
 }
 
+TEST_CASE("Expression: Substitution")
+{
+    auto const a = expression<unsigned>::symbol("a");
+    auto const b = expression<unsigned>::symbol("b");
+    auto const c = expression<unsigned>::symbol("c");
+
+    SECTION("Direct")
+    {
+        auto value = a * b + c;
+        value.substitute({{"a", expression<unsigned>(3)}, {"b", expression<unsigned>(5)}});
+
+        CHECK(value == expression<unsigned>(15) + c);
+        CHECK(value.dependencies() == std::unordered_set<std::string>{"c"});
+
+        value.substitute({{"c", expression<unsigned>(7)}});
+
+        CHECK(value.evaluate() == 22);
+    }
+    SECTION("Simultaneous")
+    {
+        // Values are not substituted again
+        auto value = a - b;
+        value.substitute({{"a", expression<>(b)}, {"b", expression<>(a)}});
+
+        CHECK(value == b - a);
+    }
+    SECTION("Indirect")
+    {
+        auto value = a.dereference<unsigned char>() + b.dereference<unsigned char>();
+        value.substitute_indirect({{expression<>(a), expression<std::byte>(std::byte{2})}, {expression<>(b), expression<std::byte>(std::byte{3})}});
+
+        CHECK(value.evaluate() == 5);
+    }
+}
+
 TEST_CASE("Expression: Evaluation")
 {
     CHECK(expression<unsigned char>(0).evaluate() == 0);
@@ -216,6 +291,26 @@ TEST_CASE("Expression: Evaluation")
     CHECK_THROWS_WITH(expression<unsigned char>::symbol("X").evaluate(), "Inconclusive evaluation");
 }
 
+TEST_CASE("Expression: Concrete and symbolic")
+{
+    auto const concrete = expression<unsigned>(0x12345678);
+
+    // Same constant, but built as a term
+    auto symbolic = expression<unsigned>::symbol("X");
+    symbolic.substitute("X", concrete);
+
+    CHECK(concrete == symbolic);
+    CHECK(std::hash<expression<unsigned>>{}(concrete) == std::hash<expression<unsigned>>{}(symbolic));
+    CHECK(concrete.representation() == symbolic.representation());
+
+    CHECK((concrete + symbolic).evaluate() == 0x2468ACF0);
+    CHECK((expression<unsigned>::symbol("X") + concrete).dependencies() == std::unordered_set<std::string>{"X"});
+    CHECK(concrete.dependencies().empty());
+
+    CHECK(expression<unsigned short>(expression<bool>(true)).evaluate() == 1);
+    CHECK(expression<bool>(concrete).evaluate());
+}
+
 TEST_CASE("Expression: Equality")
 {
     auto a = expression<unsigned>::symbol("a");
@@ -432,3 +527,24 @@ TEST_CASE("Expression: Conclusive SHR")
 
     CHECK((expression(a) >> expression(b)).evaluate() == c);
 }
+
+TEMPLATE_TEST_CASE("Expression: Conclusive folding", "", unsigned char, signed char)
+{
+    auto const a = static_cast<TestType>(GENERATE(range(0x00, 0x08), range(0x78, 0x88), range(0xF8, 0x100)));
+    auto const b = static_cast<TestType>(GENERATE(range(0x00, 0x08), range(0x78, 0x88), range(0xF8, 0x100)));
+
+    // Natively folded results have to match those of the solver
+    auto const check = [a, b](auto const& operation)
+    {
+        auto symbolic = operation(expression(a), expression<TestType>::symbol("b"));
+        symbolic.substitute("b", expression(b));
+
+        CHECK(operation(expression(a), expression(b)) == symbolic);
+    };
+
+    check([](auto const& x, auto const& y) { return x / y; });
+    check([](auto const& x, auto const& y) { return x % y; });
+    check([](auto const& x, auto const& y) { return x << y; });
+    check([](auto const& x, auto const& y) { return x >> y; });
+    check([](auto const& x, auto const& y) { return x.less_than(y); });
+}